@@ -0,0 +1,317 @@
+/**
+ * @file    ConcurrentVLVector.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Append-only Virtual Length Vector for many concurrent producers.
+ */
+
+#ifndef CONCURRENTVLVECTOR_HPP
+#define CONCURRENTVLVECTOR_HPP
+
+#include <atomic>
+#include <memory>
+#include "SegmentedVLVector.hpp"
+
+/**
+ * @brief append-only vector that many threads fill at once without a lock. a producer reserves its slot with
+ * an atomic fetch-add and builds the element there; the storage is segmented like SegmentedVLVector (the
+ * inline buffer first, then heap segments twice as large each time), and a missing segment is installed with
+ * a compare-and-swap, so no element ever moves. a producer installs the segment of a slot before it claims
+ * the slot, so a failed allocation claims nothing. an element is published once it and every element before
+ * it are built - readers see the published prefix through size(), operator[] and the iterators, and may run
+ * alongside the producers
+ * @tparam T the type of the elements, moving one may not throw
+ * @tparam StaticCapacity the size of the inline segment
+ * @tparam Allocator gives the heap segments, it is called from the producer threads
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class Allocator = VLAllocator<T>>
+class ConcurrentVLVector
+{
+	static_assert(std::is_nothrow_move_constructible<T>::value,
+				  "a reserved slot must be filled, so moving an element into it may not throw");
+
+private:
+	typedef std::allocator_traits<Allocator> _traits;
+	typedef VLSegmentMap<StaticCapacity> _map;
+	
+	/**
+	 * the most elements the vector holds, and the number of segments that reach them
+	 */
+	static constexpr size_t _maxSize = std::numeric_limits<size_t>::max() / sizeof(T);
+	static constexpr size_t _maxSegments = _map::count(_maxSize);
+	
+	/**
+	 * a segment - its slots and a ready flag per slot
+	 */
+	struct _Segment
+	{
+		T *slots;
+		std::atomic<bool> *ready;
+	};
+	
+	[[no_unique_address]] Allocator _alloc;
+	std::atomic<size_t> _reserved; // slots handed to producers
+	mutable std::atomic<size_t> _published; // a prefix known to be built, advanced lazily by size()
+	std::atomic<_Segment *> _segments[_maxSegments];
+	_Segment _inline;
+	std::atomic<bool> _inlineReady[StaticCapacity];
+	alignas(T) unsigned char stackArr[StaticCapacity * sizeof(T)]; // raw storage, segment 0
+	
+	/**
+	 * @brief the segment that holds an index, installing it if it is missing. if the allocation throws
+	 * nothing is installed and nothing leaks
+	 * @param k the segment
+	 * @return the segment
+	 */
+	_Segment *_segment(size_t k)
+	{
+		_Segment *segment = _segments[k].load(std::memory_order_acquire);
+		if (segment != nullptr)
+		{
+			return segment;
+		}
+		size_t length = _map::length(k);
+		std::unique_ptr<std::atomic<bool>[]> ready(new std::atomic<bool>[length]());
+		std::unique_ptr<_Segment> fresh(new _Segment{nullptr, ready.get()});
+		fresh->slots = _traits::allocate(_alloc, length); // the last step that may throw
+		ready.release();
+		if (_segments[k].compare_exchange_strong(segment, fresh.get(), std::memory_order_acq_rel))
+		{
+			return fresh.release();
+		}
+		// another producer installed it first, segment holds theirs
+		_freeSegment(fresh.release(), k);
+		return segment;
+	}
+	
+	/**
+	 * @brief give a heap segment back, its elements must be destroyed already
+	 * @param segment the segment
+	 * @param k its number
+	 */
+	void _freeSegment(_Segment *segment, size_t k) noexcept
+	{
+		_traits::deallocate(_alloc, segment->slots, _map::length(k));
+		delete[] segment->ready;
+		delete segment;
+	}
+	
+	/**
+	 * @brief checks if the element at an index was built
+	 * @param idx the index
+	 * @return true if it was
+	 */
+	bool _isReady(size_t idx) const
+	{
+		if (idx >= _reserved.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		size_t k = _map::segmentOf(idx);
+		_Segment *segment = _segments[k].load(std::memory_order_acquire);
+		return segment != nullptr && segment->ready[idx - _map::start(k)].load(std::memory_order_acquire);
+	}
+	
+	/**
+	 * @brief the slot of an index whose segment exists
+	 * @param idx the index
+	 * @return pointer to the slot
+	 */
+	T *_slot(size_t idx) const noexcept
+	{
+		size_t k = _map::segmentOf(idx);
+		return _segments[k].load(std::memory_order_acquire)->slots + (idx - _map::start(k));
+	}
+
+public:
+	/**
+	 * iterator traits
+	 */
+	typedef VLIndexIterator<const ConcurrentVLVector, const T> const_iterator;
+	typedef const_iterator iterator;
+	typedef T value_type;
+	typedef const T &const_reference;
+	typedef std::ptrdiff_t difference_type;
+	typedef Allocator allocator_type;
+	
+	/**
+	 * @brief default constructor - creates a size 0 vector, no element is constructed
+	 * @param alloc the allocator of the heap segments
+	 */
+	explicit ConcurrentVLVector(const Allocator &alloc = Allocator()) : _alloc(alloc), _reserved(0), _published(0)
+	{
+		for (size_t i = 0; i < StaticCapacity; i++)
+		{
+			_inlineReady[i].store(false, std::memory_order_relaxed);
+		}
+		_inline = _Segment{reinterpret_cast<T *>(stackArr), _inlineReady};
+		_segments[0].store(&_inline, std::memory_order_relaxed);
+		for (size_t k = 1; k < _maxSegments; k++)
+		{
+			_segments[k].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+	
+	ConcurrentVLVector(ConcurrentVLVector const &other) = delete;
+	
+	ConcurrentVLVector &operator=(ConcurrentVLVector const &rhs) = delete;
+	
+	/**
+	 * @brief destructor - destroys the elements and gives the heap segments back, every producer must be done
+	 */
+	~ConcurrentVLVector()
+	{
+		clear();
+		for (size_t k = 1; k < _maxSegments; k++)
+		{
+			_Segment *segment = _segments[k].load(std::memory_order_relaxed);
+			if (segment != nullptr)
+			{
+				_freeSegment(segment, k);
+			}
+		}
+	}
+	
+	/**
+	 * @brief append a copy of an element, safe to call from many threads at once
+	 * @param add element to add
+	 * @return the index the element got
+	 */
+	size_t push_back(const T &add) { return emplace_back(add); }
+	
+	/**
+	 * @brief append an element by moving it, safe to call from many threads at once
+	 * @param add element to add
+	 * @return the index the element got
+	 */
+	size_t push_back(T &&add) { return emplace_back(std::move(add)); }
+	
+	/**
+	 * @brief build an element and append it, safe to call from many threads at once. the element is built and
+	 * the segment of the next slot installed before the slot is claimed, so a throwing constructor or a
+	 * failed allocation claims nothing and leaves no hole in the vector
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor arguments of the new element
+	 * @return the index the element got
+	 */
+	template<class... Args>
+	size_t emplace_back(Args &&... args)
+	{
+		T toAdd(std::forward<Args>(args)...);
+		size_t idx = _reserved.load(std::memory_order_relaxed);
+		size_t k;
+		_Segment *segment;
+		do // on failure idx is reloaded, another producer claimed it
+		{
+			if (idx >= _maxSize)
+			{
+				throw std::length_error("ConcurrentVLVector too long");
+			}
+			k = _map::segmentOf(idx);
+			segment = _segment(k);
+		} while (!_reserved.compare_exchange_weak(idx, idx + 1, std::memory_order_relaxed));
+		size_t offset = idx - _map::start(k);
+		new(segment->slots + offset) T(std::move(toAdd));
+		segment->ready[offset].store(true, std::memory_order_release);
+		return idx;
+	}
+	
+	/**
+	 * @brief the size of the published prefix - every element below it is built and visible to the caller
+	 * @return size
+	 */
+	size_t size() const
+	{
+		size_t published = _published.load(std::memory_order_acquire);
+		while (_isReady(published))
+		{
+			// on failure published is reloaded, another reader moved it
+			if (_published.compare_exchange_weak(published, published + 1, std::memory_order_acq_rel))
+			{
+				published++;
+			}
+		}
+		return published;
+	}
+	
+	/**
+	 * @brief checks if nothing is published
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return size() == 0; }
+	
+	/**
+	 * @brief the number of slots handed to producers, published or not
+	 * @return the number of reserved slots
+	 */
+	size_t reserved() const { return _reserved.load(std::memory_order_acquire); }
+	
+	/**
+	 * @brief remove all the elements, the segments are kept. no producer or reader may be running
+	 */
+	void clear()
+	{
+		size_t count = _reserved.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) // every claimed slot is built once the producers are done
+		{
+			size_t k = _map::segmentOf(i);
+			_Segment *segment = _segments[k].load(std::memory_order_acquire);
+			segment->slots[i - _map::start(k)].~T();
+			segment->ready[i - _map::start(k)].store(false, std::memory_order_relaxed);
+		}
+		_reserved.store(0, std::memory_order_release);
+		_published.store(0, std::memory_order_release);
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it, the index must be published
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &operator[](const size_t &idx) const { return *_slot(idx); }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is published
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &at(const size_t idx) const
+	{
+		if (idx < size())
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return const_iterator(this, 0); }
+	
+	/**
+	 * @brief the end of the prefix published at the time of the call, later elements are not reached
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return const_iterator(this, size()); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief the end of the prefix published at the time of the call, later elements are not reached
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+};
+
+#endif // CONCURRENTVLVECTOR_HPP
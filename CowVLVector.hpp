@@ -0,0 +1,519 @@
+/**
+ * @file    CowVLVector.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Copy-on-write Virtual Length Vector for cheap snapshots.
+ */
+
+#ifndef COWVLVECTOR_HPP
+#define COWVLVECTOR_HPP
+
+#include <atomic>
+#include "VLVector.hpp"
+
+/**
+ * @brief a VLVector whose heap buffer is shared between copies - copying a spilled vector bumps an atomic
+ * reference count, and the first mutation of a shared buffer gives the mutating copy a buffer of its own.
+ * inline vectors are copied element by element as usual. anything that can hand out a mutable reference
+ * (operator[], at, data, begin and end on a non-const vector) counts as a mutation, and leaks the buffer -
+ * the reference may write to it later, so copies made afterwards get buffers of their own until the vector
+ * moves to a new buffer. use the const overloads (or cbegin/cend) to read a snapshot without copying it
+ * @tparam T the type of the elements
+ * @tparam StaticCapacity the inline capacity
+ * @tparam GrowthPolicy decides the heap capacity when the vector outgrows its buffer (see GrowOneAndHalf)
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf>
+class CowVLVector
+{
+private:
+	/**
+	 * the header of a heap buffer, the elements follow it
+	 */
+	struct alignas(alignof(T) > alignof(size_t) ? alignof(T) : alignof(size_t)) _Block
+	{
+		std::atomic<size_t> refs;
+		size_t cap;
+		bool leaked; // a mutable reference into the buffer was handed out, copies must not share it
+		
+		T *elems() noexcept { return reinterpret_cast<T *>(this + 1); }
+	};
+	
+	_Block *_heap; // the heap buffer, nullptr while the elements are inline
+	size_t _size;
+	alignas(T) unsigned char stackArr[StaticCapacity * sizeof(T)]; // raw storage, only [0, _size) is alive
+	
+	/**
+	 * @brief the active buffer
+	 * @return pointer to the first element
+	 */
+	T *_data() const noexcept
+	{
+		return _heap != nullptr ? _heap->elems() : reinterpret_cast<T *>(const_cast<unsigned char *>(stackArr));
+	}
+	
+	/**
+	 * @brief allocate a heap buffer, not shared yet, no element is constructed
+	 * @param cap the number of slots
+	 * @return the buffer
+	 */
+	static _Block *_allocate(size_t cap)
+	{
+		void *mem = ::operator new(sizeof(_Block) + cap * sizeof(T), std::align_val_t(alignof(_Block)));
+		_Block *block = new(mem) _Block;
+		block->refs.store(1, std::memory_order_relaxed);
+		block->cap = cap;
+		block->leaked = false;
+		return block;
+	}
+	
+	/**
+	 * @brief drop our reference to the heap buffer, destroying it if it was the last one. the elements are
+	 * inline (and none) afterwards
+	 */
+	void _drop() noexcept
+	{
+		if (_heap != nullptr)
+		{
+			if (_heap->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::destroy(_heap->elems(), _heap->elems() + _size);
+				_heap->~_Block();
+				::operator delete(static_cast<void *>(_heap), std::align_val_t(alignof(_Block)));
+			}
+			_heap = nullptr;
+		}
+		else
+		{
+			std::destroy(_data(), _data() + _size);
+		}
+		_size = 0;
+	}
+	
+	/**
+	 * @brief checks if another copy shares our heap buffer
+	 * @return true if it does
+	 */
+	bool _shared() const noexcept { return _heap != nullptr && _heap->refs.load(std::memory_order_acquire) > 1; }
+	
+	/**
+	 * @brief make sure we are the only owner of our buffer and that it holds at least cap slots. a shared buffer
+	 * is copied, a buffer of our own is moved when it is too small
+	 * @param cap the capacity we need
+	 */
+	void _own(size_t cap)
+	{
+		bool shared = _shared();
+		if (!shared && cap <= capacity())
+		{
+			return;
+		}
+		size_t newCap = cap <= capacity() ? capacity() : GrowthPolicy::grow(cap, capacity(), sizeof(T));
+		_Block *block = _allocate(newCap);
+		try
+		{
+			if (shared)
+			{
+				std::uninitialized_copy(_data(), _data() + _size, block->elems());
+			}
+			else
+			{
+				std::uninitialized_move(_data(), _data() + _size, block->elems());
+			}
+		}
+		catch (...)
+		{
+			::operator delete(static_cast<void *>(block), std::align_val_t(alignof(_Block)));
+			throw;
+		}
+		size_t size = _size;
+		_drop();
+		_heap = block;
+		_size = size;
+	}
+	
+	/**
+	 * @brief detach a shared buffer and mark it as leaked, so the reference we are about to hand out is never
+	 * seen by a copy - the copies made from now on get buffers of their own. the mark goes with the buffer
+	 */
+	void _leak()
+	{
+		_own(_size);
+		if (_heap != nullptr)
+		{
+			_heap->leaked = true;
+		}
+	}
+	
+	/**
+	 * @brief take the heap buffer of other, or move its inline elements one by one. we must be empty and
+	 * inline, and other is left that way
+	 * @param other the vector to take from
+	 */
+	void _take(CowVLVector &other) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		if (other._heap == nullptr)
+		{
+			std::uninitialized_move(other._data(), other._data() + other._size, _data());
+			std::destroy(other._data(), other._data() + other._size);
+		}
+		_heap = other._heap;
+		_size = other._size;
+		other._heap = nullptr;
+		other._size = 0;
+	}
+
+public:
+	/**
+	 * iterator traits
+	 */
+	typedef T *iterator;
+	typedef const T *const_iterator;
+	typedef T value_type;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef T *pointer;
+	typedef const T *const_pointer;
+	typedef size_t difference_type;
+	typedef std::random_access_iterator_tag iterator_category;
+	
+	/**
+	 * @brief default constructor - creates a size 0 vector, no element is constructed
+	 */
+	CowVLVector() : _heap(nullptr), _size(0) {};
+	
+	/**
+	 * @brief Creates a vector from a section of an iterative data structure
+	 * @tparam InputIterator the type of the iterator that holds the data to insert into a vector
+	 * @param first iterator to the first element in the section
+	 * @param last iterator to the last element in the section
+	 */
+	template<class InputIterator>
+	CowVLVector(InputIterator first, InputIterator last) : CowVLVector()
+	{
+		for (; first != last; ++first)
+		{
+			push_back(*first);
+		}
+	}
+	
+	/**
+	 * @brief copy constractor - shares the heap buffer in O(1), inline elements are copied. a leaked buffer
+	 * is copied too, a reference into it may still write to it
+	 * @param other the vector to be copied into a new vector
+	 */
+	CowVLVector(CowVLVector const &other) : _heap(other._heap), _size(other._size)
+	{
+		if (_heap == nullptr)
+		{
+			std::uninitialized_copy(other._data(), other._data() + other._size, _data());
+		}
+		else if (_heap->leaked)
+		{
+			_heap = _allocate(other._heap->cap);
+			try
+			{
+				std::uninitialized_copy(other._data(), other._data() + other._size, _heap->elems());
+			}
+			catch (...)
+			{
+				::operator delete(static_cast<void *>(_heap), std::align_val_t(alignof(_Block)));
+				throw;
+			}
+		}
+		else
+		{
+			_heap->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	
+	/**
+	 * @brief move constractor - takes the heap buffer, inline elements are moved one by one. other is left empty
+	 * @param other the vector to be moved into a new vector
+	 */
+	CowVLVector(CowVLVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) :
+			_heap(nullptr), _size(0)
+	{
+		_take(other);
+	}
+	
+	/**
+	 * @brief destructor - destroys the elements, the heap buffer goes when its last copy does
+	 */
+	~CowVLVector() { _drop(); }
+	
+	/**
+	 * @brief define operator '=' for vector assignment
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	CowVLVector &operator=(CowVLVector const &rhs)
+	{
+		if (&rhs != this)
+		{
+			CowVLVector copy(rhs);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief define operator '=' for vector move assignment
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	CowVLVector &operator=(CowVLVector &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		if (&rhs != this)
+		{
+			_drop();
+			_take(rhs);
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const { return _size; }
+	
+	/**
+	 * @brief getter for capacity attribute
+	 * @return capacity
+	 */
+	size_t capacity() const { return _heap != nullptr ? _heap->cap : StaticCapacity; }
+	
+	/**
+	 * @brief checks if the vector is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return _size == 0; }
+	
+	/**
+	 * @brief the number of copies that share our heap buffer, us included
+	 * @return the count, 1 for an inline vector
+	 */
+	size_t use_count() const { return _heap != nullptr ? _heap->refs.load(std::memory_order_acquire) : 1; }
+	
+	/**
+	 * @brief append the new element to the end of the vector
+	 * @param add element to add
+	 */
+	void push_back(const T &add) { emplace_back(add); }
+	
+	/**
+	 * @brief append the new element to the end of the vector by moving it
+	 * @param add element to add
+	 */
+	void push_back(T &&add) { emplace_back(std::move(add)); }
+	
+	/**
+	 * @brief construct a new element in place at the end of the vector
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor arguments of the new element
+	 * @return reference to the new element
+	 */
+	template<class... Args>
+	T &emplace_back(Args &&... args)
+	{
+		T toAdd(std::forward<Args>(args)...); // args may refer to our elements, which _own may move
+		_own(_size + 1);
+		T *added = new(_data() + _size) T(std::move(toAdd));
+		_size++;
+		return *added;
+	}
+	
+	/**
+	 * @brief removes the last element of the vector
+	 */
+	void pop_back()
+	{
+		if (_size > 0)
+		{
+			_own(_size);
+			_size--;
+			_data()[_size].~T();
+		}
+	}
+	
+	/**
+	 * @brief remove all the elements - a shared buffer is just let go
+	 */
+	void clear() { _drop(); }
+	
+	/**
+	 * @brief insert a singel data unit to the vector in a specified location
+	 * @param position specified location
+	 * @param toAdd element to insert
+	 * @return iterator to the inserted element
+	 */
+	iterator insert(const_iterator position, const T &toAdd)
+	{
+		size_t disPos = position - cbegin();
+		emplace_back(toAdd);
+		std::rotate(_data() + disPos, _data() + _size - 1, _data() + _size);
+		return _data() + disPos;
+	}
+	
+	/**
+	 * @brief removes a section of elements from the vector
+	 * @param first iterator to the first element to remove
+	 * @param last iterator to the last element in the section (we don't remove it)
+	 * @return iterator to the element that followed the removed section
+	 */
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		size_t from = first - cbegin();
+		size_t numRemove = last - first;
+		if (numRemove == 0) // nothing to erase, and moving the tail onto itself would blank it
+		{
+			return _data() + from;
+		}
+		_own(_size);
+		T *data = _data();
+		std::move(data + from + numRemove, data + _size, data + from);
+		std::destroy(data + _size - numRemove, data + _size);
+		_size -= numRemove;
+		return data + from;
+	}
+	
+	/**
+	 * @brief removes an element from the vector
+	 * @param position iterator to the element
+	 * @return iterator to the element that followed it
+	 */
+	iterator erase(const_iterator position) { return erase(position, position + 1); }
+	
+	/**
+	 * @brief access the requested index for writing, the buffer is detached first if it is shared and is
+	 * never shared again
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &operator[](const size_t &idx)
+	{
+		_leak();
+		return _data()[idx];
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it, never copies
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &operator[](const size_t &idx) const { return _data()[idx]; }
+	
+	/**
+	 * @brief access the requested index for writing while verifying that the index is in the vector range,
+	 * the buffer is detached first if it is shared
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &at(const size_t idx)
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &at(const size_t idx) const
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief getter for the elements for writing, the buffer is detached first if it is shared and is never
+	 * shared again
+	 * @return pointer to the first element
+	 */
+	T *data()
+	{
+		_leak();
+		return _data();
+	}
+	
+	/**
+	 * @brief getter for the elements, never copies
+	 * @return read-only pointer to the first element
+	 */
+	const T *data() const { return _data(); }
+	
+	/**
+	 * @brief Define a comparison between vectors, copies that share a buffer are equal right away
+	 * @param rhs right hand size vector to compere to
+	 * @return if equal - true otherwise - false
+	 */
+	bool operator==(const CowVLVector &rhs) const
+	{
+		if (_size != rhs._size)
+		{
+			return false;
+		}
+		return (_heap != nullptr && _heap == rhs._heap) || std::equal(cbegin(), cend(), rhs.cbegin());
+	}
+	
+	/**
+	 * @brief use the comparison between vectors function to assess if the
+	 * vectors are not equal
+	 * @param rhs right hand size vector to compere to
+	 * @return if not equal - true otherwise - false
+	 */
+	bool operator!=(const CowVLVector &rhs) const { return !(*this == rhs); }
+	
+	/**
+	 * @brief the buffer is detached first if it is shared
+	 * @return iterator to the vector's begin
+	 */
+	iterator begin() { return data(); }
+	
+	/**
+	 * @brief the buffer is detached first if it is shared
+	 * @return iterator to the vector's end
+	 */
+	iterator end() { return data() + _size; }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return _data(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return _data() + _size; }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+};
+
+#endif // COWVLVECTOR_HPP
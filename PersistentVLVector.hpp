@@ -0,0 +1,420 @@
+/**
+ * @file    PersistentVLVector.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   File-backed Virtual Length Vector over a memory-mapped file.
+ */
+
+#ifndef PERSISTENTVLVECTOR_HPP
+#define PERSISTENTVLVECTOR_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "VLVector.hpp"
+
+#define VL_FILE_MAGIC 0x524f544345564c56ull // "VLVECTOR"
+#define VL_FILE_VERSION 1u
+
+/**
+ * @brief the header at the start of a PersistentVLVector file, the elements follow it at dataOffset
+ */
+struct VLFileHeader
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t elemSize;
+	uint64_t typeTag;  // chosen by the user, tells record layouts of the same size apart
+	uint64_t size;     // number of live elements
+	uint64_t capacity; // number of slots the file holds
+	uint64_t dataOffset;
+};
+
+/**
+ * @brief vector of trivially copyable elements that lives in a file. the file is mapped shared, so every
+ * change is in the file as soon as it is made, and reopening the file attaches to the elements where they
+ * are instead of reading them. growth extends the file and remaps it.
+ * there is no inline tier - the elements must outlive the process, so they are always in the mapping
+ * @tparam T the type of the elements, must be trivially copyable
+ * @tparam GrowthPolicy decides the capacity of the file when the vector outgrows it (see GrowOneAndHalf)
+ */
+template<class T, class GrowthPolicy = GrowOneAndHalf>
+class PersistentVLVector
+{
+	static_assert(std::is_trivially_copyable<T>::value, "a PersistentVLVector holds trivially copyable elements");
+
+private:
+	int _fd;
+	unsigned char *_base; // the mapping, the header is at its start
+	size_t _mapped;       // size of the mapping in bytes
+	T *_data;
+	
+	/**
+	 * @brief the header of the file
+	 * @return the header, inside the mapping
+	 */
+	VLFileHeader *_header() const noexcept { return reinterpret_cast<VLFileHeader *>(_base); }
+	
+	/**
+	 * @brief where the elements start in the file, past the header and aligned for T
+	 * @return the offset in bytes
+	 */
+	static constexpr size_t _dataOffset()
+	{
+		return (sizeof(VLFileHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+	}
+	
+	/**
+	 * @brief throw the error of the last failed system call
+	 * @param what the call that failed
+	 */
+	static void _fail(const char *what) { throw std::system_error(errno, std::generic_category(), what); }
+	
+	/**
+	 * @brief resize the file to hold cap slots and remap it, the elements are kept
+	 * @param cap the new capacity
+	 */
+	void _remap(size_t cap)
+	{
+		if (cap > (std::numeric_limits<off_t>::max() - _dataOffset()) / sizeof(T))
+		{
+			throw std::length_error("PersistentVLVector too long");
+		}
+		size_t bytes = _dataOffset() + cap * sizeof(T);
+		if (ftruncate(_fd, (off_t) bytes) != 0)
+		{
+			_fail("ftruncate");
+		}
+#ifdef __linux__
+		void *p = mremap(_base, _mapped, bytes, MREMAP_MAYMOVE);
+		if (p == MAP_FAILED)
+		{
+			_fail("mremap");
+		}
+#else
+		munmap(_base, _mapped);
+		void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (p == MAP_FAILED)
+		{
+			_fail("mmap");
+		}
+#endif
+		_base = static_cast<unsigned char *>(p);
+		_mapped = bytes;
+		_data = reinterpret_cast<T *>(_base + _dataOffset());
+		_header()->capacity = cap;
+	}
+	
+	/**
+	 * @brief make room for newSize elements, growing the file by the growth policy
+	 * @param newSize the size the vector is about to have
+	 */
+	void _reCap(size_t newSize)
+	{
+		if (newSize > capacity())
+		{
+			_remap(GrowthPolicy::grow(newSize, capacity(), sizeof(T)));
+		}
+	}
+
+public:
+	/**
+	 * iterator traits
+	 */
+	typedef T *iterator;
+	typedef const T *const_iterator;
+	typedef T value_type;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef T *pointer;
+	typedef const T *const_pointer;
+	typedef size_t difference_type;
+	typedef std::random_access_iterator_tag iterator_category;
+	
+	/**
+	 * @brief opens the vector stored in a file, or creates an empty one if the file is new or empty.
+	 * an existing file is attached as is, nothing is read
+	 * @param path the file
+	 * @param typeTag must match the tag the file was created with
+	 */
+	explicit PersistentVLVector(const char *path, uint64_t typeTag = 0) : _fd(-1), _base(nullptr), _mapped(0),
+																		  _data(nullptr)
+	{
+		_fd = open(path, O_RDWR | O_CREAT, 0644);
+		if (_fd < 0)
+		{
+			_fail("open");
+		}
+		struct stat st{};
+		if (fstat(_fd, &st) != 0)
+		{
+			close(_fd);
+			_fail("fstat");
+		}
+		bool fresh = st.st_size == 0;
+		_mapped = fresh ? _dataOffset() : (size_t) st.st_size;
+		if (fresh && ftruncate(_fd, (off_t) _mapped) != 0)
+		{
+			close(_fd);
+			_fail("ftruncate");
+		}
+		void *p = _mapped < sizeof(VLFileHeader) ? MAP_FAILED :
+				  mmap(nullptr, _mapped, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (p == MAP_FAILED)
+		{
+			close(_fd);
+			throw std::runtime_error("not a VLVector file");
+		}
+		_base = static_cast<unsigned char *>(p);
+		VLFileHeader *header = _header();
+		if (fresh)
+		{
+			*header = VLFileHeader{VL_FILE_MAGIC, VL_FILE_VERSION, sizeof(T), typeTag, 0, 0, _dataOffset()};
+		}
+		else if (header->magic != VL_FILE_MAGIC || header->version != VL_FILE_VERSION ||
+				 header->elemSize != sizeof(T) || header->typeTag != typeTag || header->dataOffset != _dataOffset() ||
+				 header->size > header->capacity || _mapped < _dataOffset() ||
+				 header->capacity > (_mapped - _dataOffset()) / sizeof(T)) // the slots must fit in the file
+		{
+			munmap(_base, _mapped);
+			close(_fd);
+			throw std::runtime_error("the file does not hold a vector of this type");
+		}
+		_data = reinterpret_cast<T *>(_base + _dataOffset());
+	}
+	
+	PersistentVLVector(PersistentVLVector const &other) = delete;
+	
+	PersistentVLVector &operator=(PersistentVLVector const &rhs) = delete;
+	
+	/**
+	 * @brief destructor - unmaps and closes the file, its contents stay
+	 */
+	~PersistentVLVector()
+	{
+		munmap(_base, _mapped);
+		close(_fd);
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const { return _header()->size; }
+	
+	/**
+	 * @brief getter for capacity attribute
+	 * @return capacity
+	 */
+	size_t capacity() const { return _header()->capacity; }
+	
+	/**
+	 * @brief checks if the vector is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return size() == 0; }
+	
+	/**
+	 * @brief append the new element to the end of the vector
+	 * @param add element to add
+	 */
+	void push_back(const T &add)
+	{
+		T toAdd = add; // add may be one of our elements, and growing remaps them
+		_reCap(size() + 1);
+		_data[size()] = toAdd;
+		_header()->size++;
+	}
+	
+	/**
+	 * @brief construct a new element at the end of the vector
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor arguments of the new element
+	 * @return reference to the new element
+	 */
+	template<class... Args>
+	T &emplace_back(Args &&... args)
+	{
+		push_back(T(std::forward<Args>(args)...));
+		return *(end() - 1);
+	}
+	
+	/**
+	 * @brief removes the last element of the vector
+	 */
+	void pop_back()
+	{
+		if (!empty())
+		{
+			_header()->size--;
+		}
+	}
+	
+	/**
+	 * @brief remove all the elements, the file keeps its capacity
+	 */
+	void clear() { _header()->size = 0; }
+	
+	/**
+	 * @brief grow the file to hold at least n elements, exactly n if it has to grow
+	 * @param n the number of elements to make room for
+	 */
+	void reserve(size_t n)
+	{
+		if (n > capacity())
+		{
+			_remap(n);
+		}
+	}
+	
+	/**
+	 * @brief change the number of elements, new ones are value-initialized
+	 * @param count the new size
+	 */
+	void resize(size_t count) { resize(count, T()); }
+	
+	/**
+	 * @brief change the number of elements, new ones are copies of val
+	 * @param count the new size
+	 * @param val the value of the new elements
+	 */
+	void resize(size_t count, const T &val)
+	{
+		T toAdd = val;
+		_reCap(count);
+		if (count > size())
+		{
+			std::fill(end(), begin() + count, toAdd);
+		}
+		_header()->size = count;
+	}
+	
+	/**
+	 * @brief cut the file down to the live elements
+	 */
+	void shrink_to_fit()
+	{
+		if (capacity() > size())
+		{
+			_remap(size());
+		}
+	}
+	
+	/**
+	 * @brief write the dirty pages to the file now, without it the kernel writes them back on its own schedule
+	 */
+	void sync()
+	{
+		if (msync(_base, _mapped, MS_SYNC) != 0)
+		{
+			_fail("msync");
+		}
+	}
+	
+	/**
+	 * @brief getter for the elements
+	 * @return pointer to the first element
+	 */
+	T *data() { return _data; }
+	
+	/**
+	 * @brief getter for the elements
+	 * @return read-only pointer to the first element
+	 */
+	const T *data() const { return _data; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &operator[](const size_t &idx) { return _data[idx]; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &operator[](const size_t &idx) const { return _data[idx]; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &at(const size_t idx)
+	{
+		if (idx < size())
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &at(const size_t idx) const
+	{
+		if (idx < size())
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's begin
+	 */
+	iterator begin() { return _data; }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's end
+	 */
+	iterator end() { return _data + size(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return _data; }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return _data + size(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+};
+
+#endif // PERSISTENTVLVECTOR_HPP
@@ -0,0 +1,509 @@
+/**
+ * @file    SegmentedVLVector.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Virtual Length Vector that grows by segments, so its elements never move.
+ */
+
+#ifndef SEGMENTEDVLVECTOR_HPP
+#define SEGMENTEDVLVECTOR_HPP
+
+#include <limits>
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+
+/**
+ * @brief the layout of a segmented vector - segment 0 is the inline buffer of StaticCapacity slots, segment
+ * k > 0 holds StaticCapacity * 2^(k-1) slots, so the first k segments hold StaticCapacity * 2^(k-1) in all
+ * and the segment of an index is found with a count of leading zeros
+ * @tparam StaticCapacity the number of inline slots
+ */
+template<unsigned long StaticCapacity>
+struct VLSegmentMap
+{
+	static_assert(StaticCapacity > 0, "segment 0 is the inline buffer, it cannot be empty");
+	
+	/**
+	 * @brief the segment that holds an index
+	 * @param idx the index
+	 * @return the segment
+	 */
+	static constexpr size_t segmentOf(size_t idx)
+	{
+		if (idx < StaticCapacity)
+		{
+			return 0;
+		}
+		size_t q = idx / StaticCapacity; // at least 1, the segment is floor(log2(q)) + 1
+#if defined(__GNUC__) || defined(__clang__)
+		return 64 - __builtin_clzll(q);
+#else
+		size_t k = 0;
+		while (q != 0)
+		{
+			q >>= 1;
+			k++;
+		}
+		return k;
+#endif
+	}
+	
+	/**
+	 * @brief the index of the first slot of a segment
+	 * @param k the segment
+	 * @return the index
+	 */
+	static constexpr size_t start(size_t k) { return k == 0 ? 0 : StaticCapacity << (k - 1); }
+	
+	/**
+	 * @brief the number of slots of a segment
+	 * @param k the segment
+	 * @return the number of slots
+	 */
+	static constexpr size_t length(size_t k) { return k == 0 ? StaticCapacity : StaticCapacity << (k - 1); }
+	
+	/**
+	 * @brief the number of segments that hold every index below a count, segment 0 included
+	 * @param count the number of indices, at least 1
+	 * @return the number of segments
+	 */
+	static constexpr size_t count(size_t count) { return segmentOf(count - 1) + 1; }
+};
+
+/**
+ * @brief a VLVector that never moves its elements - the inline buffer is the first segment, and growth adds a
+ * heap segment twice as large as the one before instead of reallocating. pointers and references to elements
+ * stay valid until the element is removed, iterators until the vector is destroyed
+ * @tparam T the type of the elements
+ * @tparam StaticCapacity the size of the inline segment
+ * @tparam Allocator gives the heap segments
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class Allocator = VLAllocator<T>>
+class SegmentedVLVector
+{
+private:
+	typedef std::allocator_traits<Allocator> _traits;
+	typedef typename _traits::template rebind_alloc<T *> _TableAlloc;
+	typedef std::allocator_traits<_TableAlloc> _tableTraits;
+	typedef VLSegmentMap<StaticCapacity> _map;
+	
+	/**
+	 * the number of segments that reach every element the vector can address
+	 */
+	static constexpr size_t _maxSegments = _map::count(std::numeric_limits<size_t>::max() / sizeof(T));
+	
+	[[no_unique_address]] Allocator _alloc;
+	size_t _size;
+	size_t _segCount; // segments in use, the inline one included
+	T **_segments; // the heap segments, [0] is unused. allocated with the first of them, nullptr until then
+	alignas(T) unsigned char stackArr[StaticCapacity * sizeof(T)]; // raw storage, segment 0
+	
+	/**
+	 * @brief typed view of the inline storage
+	 * @return pointer to the first inline slot
+	 */
+	T *_stack() noexcept { return reinterpret_cast<T *>(stackArr); }
+	
+	/**
+	 * @brief typed read-only view of the inline storage
+	 * @return pointer to the first inline slot
+	 */
+	const T *_stack() const noexcept { return reinterpret_cast<const T *>(stackArr); }
+	
+	/**
+	 * @brief the slot of an index
+	 * @param idx the index, below capacity
+	 * @return pointer to the slot
+	 */
+	T *_slot(size_t idx) const noexcept
+	{
+		size_t k = _map::segmentOf(idx);
+		T *segment = k == 0 ? const_cast<T *>(_stack()) : _segments[k];
+		return segment + (idx - _map::start(k));
+	}
+	
+	/**
+	 * @brief add the next heap segment, and the segment table with the first one
+	 */
+	void _addSegment()
+	{
+		if (_segCount == _maxSegments)
+		{
+			throw std::length_error("SegmentedVLVector too long");
+		}
+		if (_segments == nullptr)
+		{
+			_TableAlloc tableAlloc(_alloc);
+			_segments = _tableTraits::allocate(tableAlloc, _maxSegments);
+		}
+		_segments[_segCount] = _traits::allocate(_alloc, _map::length(_segCount));
+		_segCount++;
+	}
+	
+	/**
+	 * @brief give back the heap segments above a count, and the segment table when none is left
+	 * @param count the number of segments to keep, the inline one included
+	 */
+	void _dropSegments(size_t count) noexcept
+	{
+		while (_segCount > count)
+		{
+			_segCount--;
+			_traits::deallocate(_alloc, _segments[_segCount], _map::length(_segCount));
+		}
+		if (_segCount == 1 && _segments != nullptr)
+		{
+			_TableAlloc tableAlloc(_alloc);
+			_tableTraits::deallocate(tableAlloc, _segments, _maxSegments);
+			_segments = nullptr;
+		}
+	}
+	
+	/**
+	 * @brief destroy the elements and give the heap segments back
+	 */
+	void _release() noexcept
+	{
+		clear();
+		_dropSegments(1);
+	}
+	
+	/**
+	 * @brief take the heap segments of other and move its inline elements one by one, we must be empty with
+	 * no heap segment, and other is left that way
+	 * @param other the vector to take from
+	 */
+	void _steal(SegmentedVLVector &other) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		size_t inlineCount = std::min<size_t>(other._size, StaticCapacity);
+		std::uninitialized_move(other._stack(), other._stack() + inlineCount, _stack());
+		std::destroy(other._stack(), other._stack() + inlineCount);
+		_segments = other._segments;
+		_segCount = other._segCount;
+		_size = other._size;
+		other._segments = nullptr;
+		other._segCount = 1;
+		other._size = 0;
+	}
+
+public:
+	/**
+	 * iterator traits
+	 */
+	typedef VLIndexIterator<SegmentedVLVector, T> iterator;
+	typedef VLIndexIterator<const SegmentedVLVector, const T> const_iterator;
+	typedef T value_type;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef T *pointer;
+	typedef const T *const_pointer;
+	typedef std::ptrdiff_t difference_type;
+	typedef Allocator allocator_type;
+	
+	/**
+	 * @brief default constructor - creates a size 0 vector, no element is constructed
+	 */
+	SegmentedVLVector() : _size(0), _segCount(1), _segments(nullptr) {};
+	
+	/**
+	 * @brief creates a size 0 vector whose heap segments will come from the given allocator
+	 * @param alloc the allocator
+	 */
+	explicit SegmentedVLVector(const Allocator &alloc) : _alloc(alloc), _size(0), _segCount(1), _segments(nullptr) {};
+	
+	/**
+	 * @brief Creates a vector from a section of an iterative data structure
+	 * @tparam InputIterator the type of the iterator that holds the data to insert into a vector
+	 * @param first iterator to the first element in the section
+	 * @param last iterator to the last element in the section
+	 * @param alloc the allocator of the new vector
+	 */
+	template<class InputIterator>
+	SegmentedVLVector(InputIterator first, InputIterator last, const Allocator &alloc = Allocator()) :
+			SegmentedVLVector(alloc)
+	{
+		for (; first != last; ++first)
+		{
+			push_back(*first);
+		}
+	}
+	
+	/**
+	 * @brief copy constractor
+	 * @param other the vector to be copied into a new vector
+	 */
+	SegmentedVLVector(SegmentedVLVector const &other) :
+			SegmentedVLVector(other.begin(), other.end(), _traits::select_on_container_copy_construction(other._alloc)) {};
+	
+	/**
+	 * @brief move constractor - steals the heap segments, inline elements are moved one by one. other is left
+	 * empty
+	 * @param other the vector to be moved into a new vector
+	 */
+	SegmentedVLVector(SegmentedVLVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) :
+			_alloc(std::move(other._alloc)), _size(0), _segCount(1), _segments(nullptr)
+	{
+		_steal(other);
+	}
+	
+	/**
+	 * @brief destructor - destroys the elements and gives the heap segments back
+	 */
+	~SegmentedVLVector() { _release(); }
+	
+	/**
+	 * @brief define operator '=' for vector assignment, our segments are reused
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	SegmentedVLVector &operator=(SegmentedVLVector const &rhs)
+	{
+		if (&rhs != this)
+		{
+			clear();
+			for (const T &val : rhs)
+			{
+				push_back(val);
+			}
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief define operator '=' for vector move assignment - the heap segments are stolen when the allocators
+	 * allow it, otherwise the elements are moved one by one. rhs is left empty
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	SegmentedVLVector &operator=(SegmentedVLVector &&rhs)
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		_release();
+		if constexpr (_traits::propagate_on_container_move_assignment::value)
+		{
+			_alloc = std::move(rhs._alloc);
+		}
+		if (_alloc == rhs._alloc)
+		{
+			_steal(rhs);
+		}
+		else
+		{
+			for (T &val : rhs)
+			{
+				push_back(std::move(val));
+			}
+			rhs.clear();
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const { return _size; }
+	
+	/**
+	 * @brief getter for capacity attribute
+	 * @return capacity
+	 */
+	size_t capacity() const { return _map::start(_segCount); }
+	
+	/**
+	 * @brief checks if the vector is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return _size == 0; }
+	
+	/**
+	 * @brief getter for the allocator
+	 * @return a copy of the allocator
+	 */
+	Allocator get_allocator() const { return _alloc; }
+	
+	/**
+	 * @brief add segments until n elements fit, no element moves
+	 * @param n the number of elements to make room for
+	 */
+	void reserve(size_t n)
+	{
+		while (capacity() < n)
+		{
+			_addSegment();
+		}
+	}
+	
+	/**
+	 * @brief append the new element to the end of the vector
+	 * @param add element to add
+	 */
+	void push_back(const T &add) { emplace_back(add); }
+	
+	/**
+	 * @brief append the new element to the end of the vector by moving it
+	 * @param add element to add
+	 */
+	void push_back(T &&add) { emplace_back(std::move(add)); }
+	
+	/**
+	 * @brief construct a new element in place at the end of the vector, adding a segment if the last one is
+	 * full. args may refer to our elements, they do not move
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor arguments of the new element
+	 * @return reference to the new element
+	 */
+	template<class... Args>
+	T &emplace_back(Args &&... args)
+	{
+		if (_size == capacity())
+		{
+			_addSegment();
+		}
+		T *slot = new(_slot(_size)) T(std::forward<Args>(args)...);
+		_size++;
+		return *slot;
+	}
+	
+	/**
+	 * @brief removes the last element of the vector, the segments are kept
+	 */
+	void pop_back()
+	{
+		if (_size > 0)
+		{
+			_size--;
+			_slot(_size)->~T();
+		}
+	}
+	
+	/**
+	 * @brief remove all the elements, the segments are kept
+	 */
+	void clear() noexcept
+	{
+		for (size_t i = 0; i < _size; i++)
+		{
+			_slot(i)->~T();
+		}
+		_size = 0;
+	}
+	
+	/**
+	 * @brief give back the heap segments that hold no element
+	 */
+	void shrink_to_fit()
+	{
+		_dropSegments(_size == 0 ? 1 : _map::count(_size));
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &operator[](const size_t &idx) { return *_slot(idx); }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &operator[](const size_t &idx) const { return *_slot(idx); }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &at(const size_t idx)
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &at(const size_t idx) const
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief Define a comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if equal - true otherwise - false
+	 */
+	bool operator==(const SegmentedVLVector &rhs) const
+	{
+		return _size == rhs._size && std::equal(begin(), end(), rhs.begin());
+	}
+	
+	/**
+	 * @brief use the comparison between vectors function to assess if the
+	 * vectors are not equal
+	 * @param rhs right hand size vector to compere to
+	 * @return if not equal - true otherwise - false
+	 */
+	bool operator!=(const SegmentedVLVector &rhs) const { return !(*this == rhs); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's begin
+	 */
+	iterator begin() { return iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's end
+	 */
+	iterator end() { return iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return const_iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return const_iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+};
+
+#endif // SEGMENTEDVLVECTOR_HPP
@@ -0,0 +1,277 @@
+/**
+ * @file    VLArena.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Bump-pointer arena for batch-scoped VLVectors.
+ */
+
+#ifndef VLARENA_HPP
+#define VLARENA_HPP
+
+#include <cstdint>
+#include <limits>
+#include "VLVector.hpp"
+
+/**
+ * @brief bump-pointer arena - memory is handed out from big chunks and only comes back all at once on reset()
+ * or when the arena dies. the last block handed out can still grow or be rolled back in place
+ */
+class VLArena
+{
+public:
+	/**
+	 * @brief creates an empty arena, no chunk is taken before the first allocation
+	 * @param chunkSize the size of the chunks taken from malloc, a larger block gets a chunk of its own
+	 */
+	explicit VLArena(size_t chunkSize = 64 * 1024) : _chunkSize(chunkSize), _chunks(nullptr), _cur(nullptr),
+													 _end(nullptr) {}
+	
+	VLArena(VLArena const &other) = delete;
+	
+	VLArena &operator=(VLArena const &rhs) = delete;
+	
+	/**
+	 * @brief destructor - gives every chunk back to malloc
+	 */
+	~VLArena() { _freeChunks(nullptr); }
+	
+	/**
+	 * @brief bump out a block
+	 * @param bytes the size of the block
+	 * @param align the alignment of the block, a power of two
+	 * @return pointer to the block
+	 */
+	void *allocate(size_t bytes, size_t align)
+	{
+		unsigned char *p = _align(_cur, align);
+		if (_cur == nullptr || p > _end || bytes > (size_t) (_end - p)) // aligning may step past the chunk's end
+		{
+			if (bytes > std::numeric_limits<size_t>::max() - align - sizeof(_Chunk))
+			{
+				throw std::bad_alloc();
+			}
+			_newChunk(bytes + align);
+			p = _align(_cur, align);
+		}
+		_cur = p + bytes;
+		return p;
+	}
+	
+	/**
+	 * @brief resize a block in place, possible only for the last block handed out
+	 * @param p the block
+	 * @param oldBytes its current size
+	 * @param bytes the size it should have
+	 * @return true if the block now has the new size, false if nothing changed
+	 */
+	bool extend(void *p, size_t oldBytes, size_t bytes)
+	{
+		unsigned char *block = static_cast<unsigned char *>(p);
+		if (block + oldBytes != _cur || bytes > (size_t) (_end - block))
+		{
+			return false;
+		}
+		_cur = block + bytes;
+		return true;
+	}
+	
+	/**
+	 * @brief give a block back - only the last block handed out is really reused, the others wait for reset()
+	 * @param p the block
+	 * @param bytes its size
+	 */
+	void release(void *p, size_t bytes) noexcept
+	{
+		unsigned char *block = static_cast<unsigned char *>(p);
+		if (block + bytes == _cur)
+		{
+			_cur = block;
+		}
+	}
+	
+	/**
+	 * @brief give back everything that was handed out in one go. the newest chunk is kept for the next batch,
+	 * the rest go back to malloc. every block of this arena is invalid afterwards
+	 */
+	void reset() noexcept
+	{
+		if (_chunks == nullptr)
+		{
+			return;
+		}
+		_freeChunks(_chunks);
+		_cur = reinterpret_cast<unsigned char *>(_chunks + 1);
+	}
+	
+	/**
+	 * @brief getter for the bytes held from malloc
+	 * @return the total size of the chunks
+	 */
+	size_t reserved() const
+	{
+		size_t total = 0;
+		for (_Chunk *chunk = _chunks; chunk != nullptr; chunk = chunk->next)
+		{
+			total += chunk->size;
+		}
+		return total;
+	}
+
+private:
+	/**
+	 * the chunks are linked newest first, the blocks start right after this header
+	 */
+	struct alignas(std::max_align_t) _Chunk
+	{
+		_Chunk *next;
+		size_t size;
+	};
+	
+	size_t _chunkSize;
+	_Chunk *_chunks;
+	unsigned char *_cur; // next free byte of the newest chunk
+	unsigned char *_end; // end of the newest chunk
+	
+	/**
+	 * @brief round a pointer up to an alignment
+	 * @param p the pointer
+	 * @param align a power of two
+	 * @return the aligned pointer
+	 */
+	static unsigned char *_align(unsigned char *p, size_t align)
+	{
+		return reinterpret_cast<unsigned char *>((reinterpret_cast<uintptr_t>(p) + align - 1) & ~(uintptr_t) (align - 1));
+	}
+	
+	/**
+	 * @brief take a new chunk from malloc and start bumping in it
+	 * @param minBytes the chunk must have at least this many usable bytes
+	 */
+	void _newChunk(size_t minBytes)
+	{
+		size_t size = std::max(_chunkSize, minBytes);
+		void *mem = std::malloc(sizeof(_Chunk) + size);
+		if (mem == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		_Chunk *chunk = static_cast<_Chunk *>(mem);
+		chunk->next = _chunks;
+		chunk->size = size;
+		_chunks = chunk;
+		_cur = reinterpret_cast<unsigned char *>(chunk + 1);
+		_end = _cur + size;
+	}
+	
+	/**
+	 * @brief free the chunks, except for one
+	 * @param keep the chunk to keep, or nullptr to free them all
+	 */
+	void _freeChunks(_Chunk *keep) noexcept
+	{
+		_Chunk *chunk = _chunks;
+		while (chunk != nullptr)
+		{
+			_Chunk *next = chunk->next;
+			if (chunk != keep)
+			{
+				std::free(chunk);
+			}
+			chunk = next;
+		}
+		if (keep != nullptr)
+		{
+			keep->next = nullptr;
+		}
+		_chunks = keep;
+	}
+};
+
+/**
+ * @brief allocator that draws VLVector heap buffers from a VLArena. deallocate does nothing (beyond rolling
+ * back the arena's last block), so vectors that die with their batch cost no free, the memory comes back on
+ * the arena's reset(). a trivially relocatable buffer that is the arena's last block grows in place
+ * @tparam T the type of the elements
+ */
+template<class T>
+struct VLArenaAllocator
+{
+	typedef T value_type;
+	
+	/**
+	 * @brief creates an allocator that draws from the given arena, which must outlive every buffer it gives
+	 * @param arena the arena
+	 */
+	VLArenaAllocator(VLArena &arena) noexcept : _arena(&arena) {}
+	
+	template<class U>
+	VLArenaAllocator(const VLArenaAllocator<U> &other) noexcept : _arena(other.arena()) {}
+	
+	/**
+	 * @brief take a block for n elements from the arena
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	T *allocate(size_t n)
+	{
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+		{
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+	}
+	
+	/**
+	 * @brief nothing is freed, the arena takes the block back on reset()
+	 * @param p pointer to the first slot
+	 * @param n number of slots
+	 */
+	void deallocate(T *p, size_t n) noexcept { _arena->release(p, n * sizeof(T)); }
+	
+	/**
+	 * @brief resize a block in place if it is the arena's last one, otherwise bump a new block and copy the
+	 * bytes. only valid for trivially relocatable elements
+	 * @param p pointer to the first slot
+	 * @param oldN the current number of slots
+	 * @param n the new number of slots
+	 * @return pointer to the resized block
+	 */
+	T *reallocate(T *p, size_t oldN, size_t n)
+	{
+		if (_arena->extend(p, oldN * sizeof(T), n * sizeof(T)))
+		{
+			return p;
+		}
+		T *newP = allocate(n);
+		std::memcpy(static_cast<void *>(newP), static_cast<const void *>(p), std::min(oldN, n) * sizeof(T));
+		return newP;
+	}
+	
+	/**
+	 * @brief getter for the arena
+	 * @return the arena this allocator draws from
+	 */
+	VLArena *arena() const noexcept { return _arena; }
+
+private:
+	VLArena *_arena;
+};
+
+template<class T, class U>
+bool operator==(const VLArenaAllocator<T> &lhs, const VLArenaAllocator<U> &rhs) noexcept
+{
+	return lhs.arena() == rhs.arena();
+}
+
+template<class T, class U>
+bool operator!=(const VLArenaAllocator<T> &lhs, const VLArenaAllocator<U> &rhs) noexcept { return !(lhs == rhs); }
+
+/**
+ * @brief VLVector whose heap buffers come from a VLArena
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+		class ShrinkPolicy = ShrinkBelowWatermark<>>
+using ArenaVLVector = VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, VLArenaAllocator<T>>;
+
+#endif // VLARENA_HPP
@@ -0,0 +1,1052 @@
+/**
+ * @file    VLBitVector.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Bit-packed vector of flags - 64 flags per word, word at a time operations.
+ */
+
+#ifndef VLBITVECTOR_HPP
+#define VLBITVECTOR_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+
+#define VL_WORD_BITS 64
+
+/**
+ * @brief vector of flags packed 64 to a word, with VLVector's inline buffer and policies. StaticCapacity counts
+ * bits and is rounded up to whole words, so VLBitVector<1024> keeps 128 bytes inline. count, find_first, any,
+ * all and the bitwise operators run a word at a time. bits past size() in the last word are always zero, the
+ * word operations rely on it. like std::vector<bool>, operator[] hands out a proxy instead of a bool &, there
+ * is no data() and insert/emplace/erase in the middle are not provided - VLVector<bool> stays a plain vector of
+ * bools for code that needs those
+ * @tparam StaticCapacity the number of inline bits
+ * @tparam GrowthPolicy decides the heap capacity, in words, when the vector outgrows its buffer
+ * @tparam ShrinkPolicy decides when a heap buffer is given back, in words
+ * @tparam Allocator an allocator of any type, rebound to give the heap words
+ */
+template<unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+		class ShrinkPolicy = ShrinkBelowWatermark<>, class Allocator = VLAllocator<uint64_t>>
+class VLBitVector
+{
+private:
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t> _WordAlloc;
+	typedef std::allocator_traits<_WordAlloc> _traits;
+	
+	static constexpr size_t _inlineWords = (StaticCapacity + VL_WORD_BITS - 1) / VL_WORD_BITS;
+	
+	[[no_unique_address]] _WordAlloc _alloc;
+	uint64_t *_words; // the active buffer - stackArr, or the heap buffer once we spilled
+	size_t _size; // in bits
+	union
+	{
+		size_t _heapWords; // capacity of the heap buffer, in use iff _words is not stackArr
+		uint64_t stackArr[_inlineWords];
+	};
+	
+	/**
+	 * the heap buffer can grow in place through the allocator's reallocate
+	 */
+	static constexpr bool _useRealloc = HasReallocate<_WordAlloc>::value;
+	
+	/**
+	 * @brief the number of words that hold a number of bits
+	 * @param bits the number of bits
+	 * @return the number of words
+	 */
+	static size_t _wordsFor(size_t bits) noexcept { return (bits + VL_WORD_BITS - 1) / VL_WORD_BITS; }
+	
+	/**
+	 * @brief a word with the low n bits set
+	 * @param n the number of bits, below 64
+	 * @return the mask
+	 */
+	static uint64_t _lowBits(size_t n) noexcept { return (uint64_t(1) << n) - 1; }
+	
+	/**
+	 * @brief number of set bits in a word
+	 */
+	static size_t _popcount(uint64_t word) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountll(word);
+#else
+		size_t n = 0;
+		for (; word != 0; word &= word - 1)
+		{
+			n++;
+		}
+		return n;
+#endif
+	}
+	
+	/**
+	 * @brief index of the lowest set bit of a word that is not zero
+	 */
+	static size_t _ctz(uint64_t word) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(word);
+#else
+		size_t n = 0;
+		for (; (word & 1) == 0; word >>= 1)
+		{
+			n++;
+		}
+		return n;
+#endif
+	}
+	
+	/**
+	 * @brief checks where the bits live
+	 * @return true if they are in a heap buffer, false if they are inline
+	 */
+	bool _onHeap() const noexcept { return _words != stackArr; }
+	
+	/**
+	 * @brief capacity of the active buffer in words
+	 * @return the number of words
+	 */
+	size_t _capWords() const noexcept { return _onHeap() ? _heapWords : _inlineWords; }
+	
+	/**
+	 * @brief move the live words to a buffer of newCap words, the stack if newCap is the inline size
+	 * @param newCap the new capacity in words, it holds every live bit
+	 */
+	void _moveTo(size_t newCap)
+	{
+		size_t used = _wordsFor(_size);
+		if (newCap <= _inlineWords)
+		{
+			uint64_t *oldArr = _words;
+			size_t oldCap = _heapWords; // read it before the words overwrite it
+			std::memcpy(stackArr, oldArr, used * sizeof(uint64_t));
+			_words = stackArr;
+			_traits::deallocate(_alloc, oldArr, oldCap);
+			return;
+		}
+		if constexpr (_useRealloc)
+		{
+			if (_onHeap()) // resize the heap block, the allocator may do it without a copy
+			{
+				_words = _alloc.reallocate(_words, _heapWords, newCap);
+				_heapWords = newCap;
+				return;
+			}
+		}
+		uint64_t *newArr = _traits::allocate(_alloc, newCap);
+		if (used != 0)
+		{
+			std::memcpy(newArr, _words, used * sizeof(uint64_t));
+		}
+		if (_onHeap())
+		{
+			_traits::deallocate(_alloc, _words, _heapWords);
+		}
+		_words = newArr;
+		_heapWords = newCap;
+	}
+	
+	/**
+	 * @brief grow the buffer for a new size, or give memory back if the shrink policy says so - the same
+	 * rules as VLVector, counted in words
+	 * @param newSize the size in bits the vector is about to have
+	 */
+	void _reCap(size_t newSize)
+	{
+		size_t words = _wordsFor(newSize);
+		size_t nowCap = _capWords();
+		if (words > nowCap)
+		{
+			_moveTo(std::max(words, GrowthPolicy::grow(words, nowCap, sizeof(uint64_t))));
+		}
+		else if (_onHeap() && ShrinkPolicy::shrink(words, _heapWords))
+		{
+			if (words <= _inlineWords)
+			{
+				_moveTo(_inlineWords);
+			}
+			else
+			{
+				size_t newCap = std::max(words, GrowthPolicy::grow(words, words, sizeof(uint64_t)));
+				if (newCap < _heapWords)
+				{
+					_moveTo(newCap);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * @brief make room for newSize bits through the growth policy, like VLVector. the shrink policy is not asked,
+	 * so a capacity the caller reserved is kept
+	 * @param newSize the size in bits the vector is about to have
+	 */
+	void _growFor(size_t newSize)
+	{
+		size_t words = _wordsFor(newSize);
+		size_t nowCap = _capWords();
+		if (words > nowCap)
+		{
+			_moveTo(std::max(words, GrowthPolicy::grow(words, nowCap, sizeof(uint64_t))));
+		}
+	}
+	
+	/**
+	 * @brief set the bits [first, last) to val, a word at a time
+	 * @param first the first bit
+	 * @param last past the last bit
+	 * @param val the value
+	 */
+	void _fill(size_t first, size_t last, bool val) noexcept
+	{
+		while (first < last)
+		{
+			size_t w = first / VL_WORD_BITS;
+			size_t lo = first % VL_WORD_BITS;
+			size_t hi = std::min(last - w * VL_WORD_BITS, (size_t) VL_WORD_BITS);
+			uint64_t mask = (hi == VL_WORD_BITS ? ~uint64_t(0) : _lowBits(hi)) & ~_lowBits(lo);
+			_words[w] = val ? _words[w] | mask : _words[w] & ~mask;
+			first = w * VL_WORD_BITS + hi;
+		}
+	}
+	
+	/**
+	 * @brief change the size to count bits, the new ones set to val
+	 * @param count the new size, above _size
+	 * @param val the value of the new bits
+	 */
+	void _grow(size_t count, bool val)
+	{
+		_growFor(count);
+		size_t used = _wordsFor(_size);
+		std::fill(_words + used, _words + _wordsFor(count), uint64_t(0));
+		if (val)
+		{
+			_fill(_size, count, true);
+		}
+		_size = count;
+	}
+	
+	/**
+	 * @brief drop the bits from index count on, the shrink policy may then give memory back
+	 * @param count the new size, at most _size
+	 */
+	void _truncate(size_t count)
+	{
+		_size = count;
+		_clearTail();
+		_reCap(_size);
+	}
+	
+	/**
+	 * @brief zero the bits of the last word that are past the size
+	 */
+	void _clearTail() noexcept
+	{
+		if (_size % VL_WORD_BITS != 0)
+		{
+			_words[_size / VL_WORD_BITS] &= _lowBits(_size % VL_WORD_BITS);
+		}
+	}
+	
+	/**
+	 * @brief throw unless both vectors have the same size
+	 * @param rhs the other vector
+	 */
+	void _sameSize(const VLBitVector &rhs) const
+	{
+		if (_size != rhs._size)
+		{
+			throw std::invalid_argument("the vectors differ in size");
+		}
+	}
+	
+	/**
+	 * @brief take the buffer of other, or copy its inline words, we must be empty on the stack and other is
+	 * left that way
+	 * @param other the vector to take from
+	 */
+	void _steal(VLBitVector &other) noexcept
+	{
+		if (other._onHeap())
+		{
+			_words = other._words;
+			_heapWords = other._heapWords;
+			other._words = other.stackArr;
+		}
+		else
+		{
+			std::memcpy(stackArr, other.stackArr, _wordsFor(other._size) * sizeof(uint64_t));
+		}
+		_size = other._size;
+		other._size = 0;
+	}
+	
+	/**
+	 * @brief drop every bit and give the heap buffer back, the vector is left empty on the stack
+	 */
+	void _release() noexcept
+	{
+		_size = 0;
+		if (_onHeap())
+		{
+			_traits::deallocate(_alloc, _words, _heapWords);
+			_words = stackArr;
+		}
+	}
+
+public:
+	/**
+	 * @brief a single bit - reads as a bool, and writing to it sets or clears the bit
+	 */
+	class reference
+	{
+	public:
+		reference(uint64_t *word, uint64_t mask) noexcept : _word(word), _mask(mask) {}
+		
+		reference(const reference &other) noexcept = default;
+		
+		operator bool() const noexcept { return (*_word & _mask) != 0; }
+		
+		reference &operator=(bool val) noexcept
+		{
+			*_word = val ? *_word | _mask : *_word & ~_mask;
+			return *this;
+		}
+		
+		reference &operator=(const reference &rhs) noexcept { return *this = bool(rhs); }
+		
+		bool operator~() const noexcept { return !bool(*this); }
+		
+		/**
+		 * @brief invert the bit
+		 */
+		void flip() noexcept { *_word ^= _mask; }
+		
+		/**
+		 * @brief exchange two bits
+		 * @param lhs left hand side
+		 * @param rhs right hand side
+		 */
+		friend void swap(reference lhs, reference rhs) noexcept
+		{
+			bool tmp = lhs;
+			lhs = bool(rhs);
+			rhs = tmp;
+		}
+	
+	private:
+		uint64_t *_word;
+		uint64_t _mask;
+	};
+	
+	/**
+	 * iterator traits
+	 */
+	typedef VLIndexIterator<VLBitVector, bool, reference> iterator;
+	typedef VLIndexIterator<const VLBitVector, const bool, bool> const_iterator;
+	typedef bool value_type;
+	typedef bool const_reference;
+	typedef std::ptrdiff_t difference_type;
+	typedef Allocator allocator_type;
+	
+	/**
+	 * @brief default constructor - creates a size 0 vector
+	 */
+	VLBitVector() : _words(stackArr), _size(0) {}
+	
+	/**
+	 * @brief creates a size 0 vector whose heap words will come from the given allocator
+	 * @param alloc the allocator
+	 */
+	explicit VLBitVector(const Allocator &alloc) : _alloc(alloc), _words(stackArr), _size(0) {}
+	
+	/**
+	 * @brief creates a vector of count copies of val
+	 * @param count the number of bits
+	 * @param val their value
+	 * @param alloc the allocator of the new vector
+	 */
+	VLBitVector(size_t count, bool val, const Allocator &alloc = Allocator()) : VLBitVector(alloc)
+	{
+		_grow(count, val);
+	}
+	
+	/**
+	 * @brief Creates a vector from a section of an iterative data structure
+	 * @tparam InputIterator the type of the iterator that holds the flags
+	 * @param first iterator to the first element in the section
+	 * @param last iterator to the last element in the section
+	 * @param alloc the allocator of the new vector
+	 */
+	template<class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+	VLBitVector(InputIterator first, InputIterator last, const Allocator &alloc = Allocator()) : VLBitVector(alloc)
+	{
+		assign(first, last);
+	}
+	
+	/**
+	 * @brief copy constractor - allocates once and copies the words
+	 * @param other the vector to be copied into a new vector
+	 */
+	VLBitVector(VLBitVector const &other) :
+			_alloc(_traits::select_on_container_copy_construction(other._alloc)), _words(stackArr), _size(0)
+	{
+		*this = other;
+	}
+	
+	/**
+	 * @brief move constractor - steals the heap buffer in O(1), inline words are copied. other is left empty
+	 * @param other the vector to be moved into a new vector
+	 */
+	VLBitVector(VLBitVector &&other) noexcept : _alloc(std::move(other._alloc)), _words(stackArr), _size(0)
+	{
+		_steal(other);
+	}
+	
+	/**
+	 * @brief destructor - release the heap buffer if there is one
+	 */
+	~VLBitVector() { _release(); }
+	
+	/**
+	 * @brief define operator '=' for vector assignment, our buffer is reused if the bits fit
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	VLBitVector &operator=(VLBitVector const &rhs)
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		if constexpr (_traits::propagate_on_container_copy_assignment::value)
+		{
+			if (!(_alloc == rhs._alloc)) // our buffer goes back to the allocator that gave it
+			{
+				_release();
+			}
+			_alloc = rhs._alloc;
+		}
+		size_t used = _wordsFor(rhs._size);
+		if (used > _capWords())
+		{
+			_size = 0;
+			_moveTo(used);
+		}
+		if (used != 0)
+		{
+			std::memcpy(_words, rhs._words, used * sizeof(uint64_t));
+		}
+		_size = rhs._size;
+		_reCap(_size);
+		return *this;
+	}
+	
+	/**
+	 * @brief define operator '=' for vector move assignment, rhs is left empty. the heap buffer of rhs is
+	 * taken over only if its allocator can free it here, otherwise the words are copied
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	VLBitVector &operator=(VLBitVector &&rhs) noexcept(_traits::propagate_on_container_move_assignment::value ||
+												 _traits::is_always_equal::value)
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		if (_traits::propagate_on_container_move_assignment::value || _alloc == rhs._alloc)
+		{
+			_release();
+			if constexpr (_traits::propagate_on_container_move_assignment::value)
+			{
+				_alloc = std::move(rhs._alloc);
+			}
+			_steal(rhs);
+		}
+		else
+		{
+			*this = rhs;
+			rhs.clear();
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief exchange the content of two vectors
+	 * @param other the vector to swap with
+	 */
+	void swap(VLBitVector &other)
+	{
+		VLBitVector tmp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+	
+	/**
+	 * @brief replace the content with the flags of a range
+	 * @tparam InputIterator the type of the iterator that holds the flags
+	 * @param first iterator to the first flag
+	 * @param last iterator past the last flag
+	 */
+	template<class InputIterator>
+	void assign(InputIterator first, InputIterator last)
+	{
+		_size = 0; // the words are rewritten as the flags come, the buffer is kept
+		if constexpr (std::is_base_of<std::forward_iterator_tag,
+				typename std::iterator_traits<InputIterator>::iterator_category>::value)
+		{
+			reserve(std::distance(first, last));
+		}
+		for (; first != last; ++first)
+		{
+			push_back(bool(*first));
+		}
+	}
+	
+	/**
+	 * @brief replace the content with count copies of val
+	 * @param count the number of bits
+	 * @param val their value
+	 */
+	void assign(size_t count, bool val)
+	{
+		_size = 0;
+		_grow(count, val);
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size in bits
+	 */
+	size_t size() const { return _size; }
+	
+	/**
+	 * @brief getter for capacity attribute
+	 * @return capacity in bits
+	 */
+	size_t capacity() const { return _capWords() * VL_WORD_BITS; }
+	
+	/**
+	 * @brief checks if the vector is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return _size == 0; }
+	
+	/**
+	 * @brief add a bit at the end of the vector
+	 * @param add the bit to add
+	 */
+	void push_back(bool add) { emplace_back(add); }
+	
+	/**
+	 * @brief add a bit at the end of the vector
+	 * @param add the bit to add
+	 * @return the new bit
+	 */
+	reference emplace_back(bool add)
+	{
+		if (_size % VL_WORD_BITS == 0) // the bit starts a new word
+		{
+			_growFor(_size + 1);
+			_words[_size / VL_WORD_BITS] = 0;
+		}
+		reference bit = (*this)[_size];
+		_size++;
+		bit = add;
+		return bit;
+	}
+	
+	/**
+	 * @brief remove the last bit in the vector if exists
+	 */
+	void pop_back()
+	{
+		if (_size == 0)
+		{
+			return;
+		}
+		_truncate(_size - 1);
+	}
+	
+	/**
+	 * @brief empty the vector, release allocated memory if the shrink policy says so
+	 */
+	void clear() { _truncate(0); }
+	
+	/**
+	 * @brief make room for at least n bits with a single allocation, if they do not fit the current buffer.
+	 * never shrinks
+	 * @param n the number of bits the caller is about to hold
+	 */
+	void reserve(size_t n)
+	{
+		if (_wordsFor(n) > _capWords())
+		{
+			_moveTo(_wordsFor(n));
+		}
+	}
+	
+	/**
+	 * @brief change the size, new bits are set to val
+	 * @param count the new size
+	 * @param val the value of the new bits
+	 */
+	void resize(size_t count, bool val = false)
+	{
+		if (count > _size)
+		{
+			_grow(count, val);
+		}
+		else
+		{
+			_truncate(count);
+		}
+	}
+	
+	/**
+	 * @brief give back the unused capacity - the words go back to the stack if they fit there, otherwise to a
+	 * heap buffer of exactly the words in use. does nothing if the shrink policy ignores requests
+	 */
+	void shrink_to_fit()
+	{
+		size_t used = _wordsFor(_size);
+		if (!ShrinkPolicy::onRequest || !_onHeap() || _heapWords == used)
+		{
+			return;
+		}
+		_moveTo(std::max(used, _inlineWords));
+	}
+	
+	/**
+	 * @brief the packed words, bit i of the vector is bit i % 64 of word i / 64 and the bits past size()
+	 * are zero
+	 * @return pointer to the first word
+	 */
+	const uint64_t *words() const noexcept { return _words; }
+	
+	/**
+	 * @brief the number of words that hold the bits
+	 * @return the number of words
+	 */
+	size_t word_count() const noexcept { return _wordsFor(_size); }
+	
+	/**
+	 * @brief access the requested bit
+	 * @param idx index to access
+	 * @return proxy of the bit
+	 */
+	reference operator[](const size_t &idx)
+	{
+		return reference(_words + idx / VL_WORD_BITS, uint64_t(1) << (idx % VL_WORD_BITS));
+	}
+	
+	/**
+	 * @brief access the requested bit
+	 * @param idx index to access
+	 * @return the bit
+	 */
+	bool operator[](const size_t &idx) const { return (_words[idx / VL_WORD_BITS] >> (idx % VL_WORD_BITS)) & 1; }
+	
+	/**
+	 * @brief access the requested bit, while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return proxy of the bit
+	 */
+	reference at(const size_t idx)
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief access the requested bit, while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return the bit
+	 */
+	bool at(const size_t idx) const
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief the first bit, the vector must not be empty
+	 */
+	reference front() { return (*this)[0]; }
+	
+	bool front() const { return (*this)[0]; }
+	
+	/**
+	 * @brief the last bit, the vector must not be empty
+	 */
+	reference back() { return (*this)[_size - 1]; }
+	
+	bool back() const { return (*this)[_size - 1]; }
+	
+	/**
+	 * @brief the number of set bits, a popcount per word
+	 * @return the count
+	 */
+	size_t count() const noexcept
+	{
+		size_t n = 0;
+		for (size_t w = 0, used = _wordsFor(_size); w < used; w++)
+		{
+			n += _popcount(_words[w]);
+		}
+		return n;
+	}
+	
+	/**
+	 * @brief the number of bits equal to val
+	 * @param val the value to count
+	 * @return the count
+	 */
+	size_t count(bool val) const noexcept { return val ? count() : _size - count(); }
+	
+	/**
+	 * @brief index of the first set bit
+	 * @return the index, size() if no bit is set
+	 */
+	size_t find_first() const noexcept { return _findFrom(0, true); }
+	
+	/**
+	 * @brief index of the first set bit after pos, to walk the set bits with find_first
+	 * @param pos the index to start after
+	 * @return the index, size() if no later bit is set
+	 */
+	size_t find_next(size_t pos) const noexcept { return pos + 1 >= _size ? _size : _findFrom(pos + 1, true); }
+	
+	/**
+	 * @brief find the first bit equal to val, a word at a time
+	 * @param val the value to look for
+	 * @return iterator to the bit, end() if there is none
+	 */
+	iterator find(bool val) { return begin() + _findFrom(0, val); }
+	
+	/**
+	 * @brief find the first bit equal to val, a word at a time
+	 * @param val the value to look for
+	 * @return const iterator to the bit, end() if there is none
+	 */
+	const_iterator find(bool val) const { return begin() + _findFrom(0, val); }
+	
+	/**
+	 * @brief checks if some bit equals val
+	 * @param val the value to look for
+	 * @return true if one does
+	 */
+	bool contains(bool val) const { return _findFrom(0, val) != _size; }
+	
+	/**
+	 * @brief find the first bit equal to one of the values in [first, last)
+	 * @tparam ForwardIterator the type of the iterator over the values
+	 * @param first iterator to the first value
+	 * @param last iterator past the last value
+	 * @return iterator to the bit, end() if there is none
+	 */
+	template<class ForwardIterator>
+	iterator find_first_of(ForwardIterator first, ForwardIterator last)
+	{
+		bool wanted[2] = {false, false};
+		for (; first != last; ++first)
+		{
+			wanted[bool(*first)] = true;
+		}
+		if (wanted[0] && wanted[1])
+		{
+			return begin();
+		}
+		return wanted[0] || wanted[1] ? find(wanted[1]) : end();
+	}
+	
+	/**
+	 * @brief checks if some bit is set
+	 * @return true if one is
+	 */
+	bool any() const noexcept { return find_first() != _size; }
+	
+	/**
+	 * @brief checks if no bit is set
+	 * @return true if none is
+	 */
+	bool none() const noexcept { return !any(); }
+	
+	/**
+	 * @brief checks if every bit is set, true for an empty vector
+	 * @return true if they all are
+	 */
+	bool all() const noexcept
+	{
+		size_t full = _size / VL_WORD_BITS;
+		for (size_t w = 0; w < full; w++)
+		{
+			if (_words[w] != ~uint64_t(0))
+			{
+				return false;
+			}
+		}
+		return _size % VL_WORD_BITS == 0 || _words[full] == _lowBits(_size % VL_WORD_BITS);
+	}
+	
+	/**
+	 * @brief invert every bit
+	 */
+	void flip() noexcept
+	{
+		for (size_t w = 0, used = _wordsFor(_size); w < used; w++)
+		{
+			_words[w] = ~_words[w];
+		}
+		_clearTail();
+	}
+	
+	/**
+	 * @brief keep the bits that are also set in rhs, the sizes must match (std::invalid_argument otherwise)
+	 * @param rhs right hand side
+	 * @return reference to this vector
+	 */
+	VLBitVector &operator&=(const VLBitVector &rhs)
+	{
+		_sameSize(rhs);
+		for (size_t w = 0, used = _wordsFor(_size); w < used; w++)
+		{
+			_words[w] &= rhs._words[w];
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief set the bits that are set in rhs, the sizes must match (std::invalid_argument otherwise)
+	 * @param rhs right hand side
+	 * @return reference to this vector
+	 */
+	VLBitVector &operator|=(const VLBitVector &rhs)
+	{
+		_sameSize(rhs);
+		for (size_t w = 0, used = _wordsFor(_size); w < used; w++)
+		{
+			_words[w] |= rhs._words[w];
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief invert the bits that are set in rhs, the sizes must match (std::invalid_argument otherwise)
+	 * @param rhs right hand side
+	 * @return reference to this vector
+	 */
+	VLBitVector &operator^=(const VLBitVector &rhs)
+	{
+		_sameSize(rhs);
+		for (size_t w = 0, used = _wordsFor(_size); w < used; w++)
+		{
+			_words[w] ^= rhs._words[w];
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief the bits set in both vectors
+	 */
+	friend VLBitVector operator&(VLBitVector lhs, const VLBitVector &rhs)
+	{
+		lhs &= rhs;
+		return lhs; // moved out, the compound operator's reference would be copied
+	}
+	
+	/**
+	 * @brief the bits set in either vector
+	 */
+	friend VLBitVector operator|(VLBitVector lhs, const VLBitVector &rhs)
+	{
+		lhs |= rhs;
+		return lhs;
+	}
+	
+	/**
+	 * @brief the bits set in exactly one of the vectors
+	 */
+	friend VLBitVector operator^(VLBitVector lhs, const VLBitVector &rhs)
+	{
+		lhs ^= rhs;
+		return lhs;
+	}
+	
+	/**
+	 * @brief a copy with every bit inverted
+	 */
+	VLBitVector operator~() const
+	{
+		VLBitVector inverted(*this);
+		inverted.flip();
+		return inverted;
+	}
+	
+	/**
+	 * @brief compare two vectors a word at a time
+	 * @param rhs right hand side
+	 * @return true if they hold the same bits
+	 */
+	bool operator==(const VLBitVector &rhs) const
+	{
+		return _size == rhs._size && (_size == 0 ||
+									  std::memcmp(_words, rhs._words, _wordsFor(_size) * sizeof(uint64_t)) == 0);
+	}
+	
+	/**
+	 * @brief compare two vectors a word at a time
+	 * @param rhs right hand side
+	 * @return true if they differ
+	 */
+	bool operator!=(const VLBitVector &rhs) const { return !(*this == rhs); }
+	
+	/**
+	 * @brief lexicographic order, false before true
+	 * @param rhs right hand side
+	 * @return true if this vector comes first
+	 */
+	bool operator<(const VLBitVector &rhs) const { return _less(*this, rhs); }
+	
+	/**
+	 * @brief lexicographic order, false before true
+	 * @param rhs right hand side
+	 * @return true if this vector comes last
+	 */
+	bool operator>(const VLBitVector &rhs) const { return _less(rhs, *this); }
+	
+	/**
+	 * @brief lexicographic order, false before true
+	 * @param rhs right hand side
+	 * @return true if this vector does not come last
+	 */
+	bool operator<=(const VLBitVector &rhs) const { return !_less(rhs, *this); }
+	
+	/**
+	 * @brief lexicographic order, false before true
+	 * @param rhs right hand side
+	 * @return true if this vector does not come first
+	 */
+	bool operator>=(const VLBitVector &rhs) const { return !_less(*this, rhs); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's begin
+	 */
+	iterator begin() { return iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return const_iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's end
+	 */
+	iterator end() { return iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return const_iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+
+private:
+	/**
+	 * @brief index of the first bit equal to val at or after pos
+	 * @param pos the first index to look at
+	 * @param val the value to look for, clear bits are found in the inverted words
+	 * @return the index, _size if there is none
+	 */
+	size_t _findFrom(size_t pos, bool val) const noexcept
+	{
+		uint64_t invert = val ? 0 : ~uint64_t(0);
+		size_t used = _wordsFor(_size);
+		size_t w = pos / VL_WORD_BITS;
+		if (w >= used)
+		{
+			return _size;
+		}
+		uint64_t word = (_words[w] ^ invert) & ~_lowBits(pos % VL_WORD_BITS);
+		while (word == 0)
+		{
+			if (++w == used)
+			{
+				return _size;
+			}
+			word = _words[w] ^ invert;
+		}
+		return std::min(w * VL_WORD_BITS + _ctz(word), _size); // an inverted tail is all ones
+	}
+	
+	/**
+	 * @brief lexicographic order of two vectors - the first differing bit decides, found with a xor per word
+	 * @param lhs left hand side vector
+	 * @param rhs right hand side vector
+	 * @return true if lhs comes before rhs
+	 */
+	static bool _less(const VLBitVector &lhs, const VLBitVector &rhs) noexcept
+	{
+		size_t common = std::min(lhs._size, rhs._size);
+		for (size_t w = 0, used = _wordsFor(common); w < used; w++)
+		{
+			uint64_t diff = lhs._words[w] ^ rhs._words[w];
+			if (diff != 0)
+			{
+				size_t bit = w * VL_WORD_BITS + _ctz(diff);
+				if (bit >= common) // the shorter vector ran out first
+				{
+					break;
+				}
+				return (rhs._words[w] >> (bit % VL_WORD_BITS)) & 1;
+			}
+		}
+		return lhs._size < rhs._size;
+	}
+};
+
+/**
+ * @brief exchange the content of two bit vectors, see VLBitVector::swap
+ * @param lhs left hand side
+ * @param rhs right hand side
+ */
+template<unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+void swap(VLBitVector<StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &lhs,
+		  VLBitVector<StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &rhs)
+{
+	lhs.swap(rhs);
+}
+
+#endif // VLBITVECTOR_HPP
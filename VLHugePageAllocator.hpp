@@ -0,0 +1,180 @@
+/**
+ * @file    VLHugePageAllocator.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   mmap-backed huge-page tier for very large VLVectors.
+ */
+
+#ifndef VLHUGEPAGEALLOCATOR_HPP
+#define VLHUGEPAGEALLOCATOR_HPP
+
+#include "VLVector.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#define DEFAULT_HUGE_PAGE_THRESHOLD (32ul << 20u)
+
+/**
+ * @brief allocator with two tiers - buffers below ThresholdBytes come from VLAllocator, larger ones are anonymous
+ * mappings advised to use transparent huge pages. a mapped buffer grows with mremap, which moves page tables
+ * instead of copying the elements, so trivially relocatable vectors grow without a copy once they cross the
+ * threshold. on systems without mremap every buffer stays in the VLAllocator tier
+ * @tparam T the type of the elements
+ * @tparam ThresholdBytes the smallest buffer, in bytes, that is mapped
+ */
+template<class T, size_t ThresholdBytes = DEFAULT_HUGE_PAGE_THRESHOLD>
+struct VLHugePageAllocator
+{
+	typedef T value_type;
+	
+	template<class U>
+	struct rebind
+	{
+		typedef VLHugePageAllocator<U, ThresholdBytes> other;
+	};
+	
+	VLHugePageAllocator() noexcept = default;
+	
+	template<class U>
+	VLHugePageAllocator(const VLHugePageAllocator<U, ThresholdBytes> &) noexcept {}
+	
+	/**
+	 * @brief allocate raw memory for n elements, mapped if it is at least ThresholdBytes
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	T *allocate(size_t n)
+	{
+		if (n > VLAllocator<T>::max_size()) // n * sizeof(T) would wrap around to a small block
+		{
+			throw std::bad_array_new_length();
+		}
+		if (!_mapped(n))
+		{
+			return _small().allocate(n);
+		}
+		return _map(n);
+	}
+	
+	/**
+	 * @brief release memory that was taken with allocate
+	 * @param p pointer to the first slot
+	 * @param n number of slots
+	 */
+	void deallocate(T *p, size_t n) noexcept
+	{
+		if (!_mapped(n))
+		{
+			_small().deallocate(p, n);
+			return;
+		}
+#ifdef __linux__
+		munmap(static_cast<void *>(p), n * sizeof(T));
+#endif
+	}
+	
+	/**
+	 * @brief resize a block that was taken with allocate, keeping its first min(oldN, n) elements' bytes.
+	 * only valid for trivially relocatable elements
+	 * @param p pointer to the first slot
+	 * @param oldN the current number of slots
+	 * @param n the new number of slots
+	 * @return pointer to the resized block
+	 */
+	T *reallocate(T *p, size_t oldN, size_t n)
+	{
+		if (n > VLAllocator<T>::max_size())
+		{
+			throw std::bad_array_new_length();
+		}
+		bool wasMapped = _mapped(oldN);
+		bool isMapped = _mapped(n);
+		if (!wasMapped && !isMapped)
+		{
+			return _small().reallocate(p, oldN, n);
+		}
+#ifdef __linux__
+		if (wasMapped && isMapped)
+		{
+			void *newP = mremap(static_cast<void *>(p), oldN * sizeof(T), n * sizeof(T), MREMAP_MAYMOVE);
+			if (newP == MAP_FAILED)
+			{
+				throw std::bad_alloc();
+			}
+			return static_cast<T *>(newP);
+		}
+#endif
+		// crossing the threshold, one copy
+		T *newP = allocate(n);
+		std::memcpy(static_cast<void *>(newP), static_cast<const void *>(p), std::min(oldN, n) * sizeof(T));
+		deallocate(p, oldN);
+		return newP;
+	}
+
+private:
+	/**
+	 * @brief tells which tier a buffer of n slots belongs to
+	 * @param n number of slots
+	 * @return true if it is mapped
+	 */
+	static bool _mapped(size_t n)
+	{
+#ifdef __linux__
+		return n >= (ThresholdBytes + sizeof(T) - 1) / sizeof(T); // no multiplication, it could wrap
+#else
+		return false;
+#endif
+	}
+	
+	/**
+	 * @brief the allocator of the small tier
+	 * @return the allocator
+	 */
+	static VLAllocator<T> _small() { return VLAllocator<T>(); }
+	
+	/**
+	 * @brief map an anonymous buffer of n slots and ask for huge pages on it
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	static T *_map(size_t n)
+	{
+#ifdef __linux__
+		void *p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+		{
+			throw std::bad_alloc();
+		}
+#ifdef MADV_HUGEPAGE
+		madvise(p, n * sizeof(T), MADV_HUGEPAGE);
+#endif
+		return static_cast<T *>(p);
+#else
+		return _small().allocate(n);
+#endif
+	}
+};
+
+template<class T, class U, size_t ThresholdBytes>
+bool operator==(const VLHugePageAllocator<T, ThresholdBytes> &, const VLHugePageAllocator<U, ThresholdBytes> &) noexcept
+{
+	return true;
+}
+
+template<class T, class U, size_t ThresholdBytes>
+bool operator!=(const VLHugePageAllocator<T, ThresholdBytes> &, const VLHugePageAllocator<U, ThresholdBytes> &) noexcept
+{
+	return false;
+}
+
+/**
+ * @brief VLVector whose heap buffers are mapped on huge pages once they reach ThresholdBytes
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+		class ShrinkPolicy = ShrinkBelowWatermark<>, size_t ThresholdBytes = DEFAULT_HUGE_PAGE_THRESHOLD>
+using HugeVLVector = VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, VLHugePageAllocator<T, ThresholdBytes>>;
+
+#endif // VLHUGEPAGEALLOCATOR_HPP
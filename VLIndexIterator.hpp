@@ -0,0 +1,147 @@
+/**
+ * @file    VLIndexIterator.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Random-access iterator over any container indexed with operator[].
+ */
+
+#ifndef VLINDEXITERATOR_HPP
+#define VLINDEXITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @brief random-access iterator of a container indexed with operator[], it holds the container and an index
+ * @tparam Container the container, const for a const iterator
+ * @tparam Value the type of the elements, const for a const iterator
+ * @tparam Reference what the container's operator[] returns, a proxy for containers that hold no Value objects
+ */
+template<class Container, class Value, class Reference = Value &>
+class VLIndexIterator
+{
+private:
+	/**
+	 * what operator-> gives when Reference is a proxy - it holds the proxy, so the member access does not
+	 * reach through the address of a temporary
+	 */
+	struct _ArrowProxy
+	{
+		Reference ref;
+		
+		Reference *operator->() { return &ref; }
+	};
+
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef typename std::remove_const<Value>::type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef typename std::conditional<std::is_reference<Reference>::value, Value *, _ArrowProxy>::type pointer;
+	typedef Reference reference;
+	
+	VLIndexIterator() : _vec(nullptr), _idx(0) {}
+	
+	VLIndexIterator(Container *vec, size_t idx) : _vec(vec), _idx(idx) {}
+	
+	/**
+	 * @brief a mutable iterator converts to a const one
+	 */
+	template<class OtherContainer, class OtherValue, class OtherReference,
+			class = typename std::enable_if<std::is_convertible<OtherValue *, Value *>::value>::type>
+	VLIndexIterator(const VLIndexIterator<OtherContainer, OtherValue, OtherReference> &other) :
+			_vec(other.container()), _idx(other.index()) {}
+	
+	reference operator*() const { return (*_vec)[_idx]; }
+	
+	pointer operator->() const
+	{
+		if constexpr (std::is_reference<Reference>::value)
+		{
+			return &(*_vec)[_idx];
+		}
+		else
+		{
+			return pointer{(*_vec)[_idx]};
+		}
+	}
+	
+	reference operator[](difference_type n) const { return (*_vec)[_idx + n]; }
+	
+	VLIndexIterator &operator++()
+	{
+		_idx++;
+		return *this;
+	}
+	
+	VLIndexIterator operator++(int)
+	{
+		VLIndexIterator old = *this;
+		_idx++;
+		return old;
+	}
+	
+	VLIndexIterator &operator--()
+	{
+		_idx--;
+		return *this;
+	}
+	
+	VLIndexIterator operator--(int)
+	{
+		VLIndexIterator old = *this;
+		_idx--;
+		return old;
+	}
+	
+	VLIndexIterator &operator+=(difference_type n)
+	{
+		_idx += n;
+		return *this;
+	}
+	
+	VLIndexIterator &operator-=(difference_type n)
+	{
+		_idx -= n;
+		return *this;
+	}
+	
+	VLIndexIterator operator+(difference_type n) const { return VLIndexIterator(_vec, _idx + n); }
+	
+	friend VLIndexIterator operator+(difference_type n, const VLIndexIterator &it) { return it + n; }
+	
+	VLIndexIterator operator-(difference_type n) const { return VLIndexIterator(_vec, _idx - n); }
+	
+	difference_type operator-(const VLIndexIterator &rhs) const { return (difference_type) (_idx - rhs._idx); }
+	
+	bool operator==(const VLIndexIterator &rhs) const { return _idx == rhs._idx; }
+	
+	bool operator!=(const VLIndexIterator &rhs) const { return _idx != rhs._idx; }
+	
+	bool operator<(const VLIndexIterator &rhs) const { return _idx < rhs._idx; }
+	
+	bool operator>(const VLIndexIterator &rhs) const { return _idx > rhs._idx; }
+	
+	bool operator<=(const VLIndexIterator &rhs) const { return _idx <= rhs._idx; }
+	
+	bool operator>=(const VLIndexIterator &rhs) const { return _idx >= rhs._idx; }
+	
+	/**
+	 * @brief getter for the container
+	 * @return the container
+	 */
+	Container *container() const { return _vec; }
+	
+	/**
+	 * @brief getter for the index
+	 * @return the index
+	 */
+	size_t index() const { return _idx; }
+
+private:
+	Container *_vec;
+	size_t _idx;
+};
+
+#endif // VLINDEXITERATOR_HPP
@@ -0,0 +1,452 @@
+/**
+ * @file    VLParallel.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Parallel algorithms over VLVectors on a work-stealing thread pool.
+ */
+
+#ifndef VLPARALLEL_HPP
+#define VLPARALLEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VLVector.hpp"
+
+#define VL_PARALLEL_MIN_GRAIN 4096
+#define VL_PARALLEL_TASKS_PER_THREAD 8
+
+/**
+ * @brief fork-join thread pool. a parallel loop starts as one range in the caller's queue; whoever runs a range
+ * larger than the grain splits it, keeps the first half and queues the second, and idle threads steal the
+ * oldest (largest) range of a busy queue. the caller works on its own loop until every range is done
+ */
+class VLThreadPool
+{
+public:
+	/**
+	 * @brief starts the workers
+	 * @param threads the number of threads that run a loop, the caller included
+	 */
+	explicit VLThreadPool(unsigned threads = std::thread::hardware_concurrency()) : _stop(false), _queued(0)
+	{
+		threads = std::max(threads, 1u);
+		for (unsigned i = 0; i < threads; i++)
+		{
+			_queues.emplace_back(new _Queue());
+		}
+		for (unsigned i = 1; i < threads; i++) // queue 0 is shared by the callers
+		{
+			_workers.emplace_back([this, i]
+			{
+				_work(i);
+			});
+		}
+	}
+	
+	VLThreadPool(VLThreadPool const &other) = delete;
+	
+	VLThreadPool &operator=(VLThreadPool const &rhs) = delete;
+	
+	/**
+	 * @brief destructor - stops the workers, no loop may be running
+	 */
+	~VLThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard(_sleepLock);
+			_stop = true;
+		}
+		_wake.notify_all();
+		for (std::thread &worker : _workers)
+		{
+			worker.join();
+		}
+	}
+	
+	/**
+	 * @brief the pool the algorithms use unless they are given one, with a thread per core
+	 * @return the pool
+	 */
+	static VLThreadPool &instance()
+	{
+		static VLThreadPool pool;
+		return pool;
+	}
+	
+	/**
+	 * @brief getter for the number of threads that run a loop
+	 * @return the number of threads, the caller included
+	 */
+	unsigned size() const { return (unsigned) _queues.size(); }
+	
+	/**
+	 * @brief the range size a loop over n elements is cut to - a few ranges per thread, and never below
+	 * VL_PARALLEL_MIN_GRAIN so a range pays for the handoff
+	 * @param n the number of elements
+	 * @return the grain, n itself if the loop should stay serial
+	 */
+	size_t grain(size_t n) const
+	{
+		return std::max<size_t>(VL_PARALLEL_MIN_GRAIN, n / (size() * VL_PARALLEL_TASKS_PER_THREAD));
+	}
+	
+	/**
+	 * @brief run body over [0, n) in ranges of at most grain elements, and return once all of them ran. the
+	 * first exception a range throws is rethrown here, after the others finished
+	 * @param n the number of elements
+	 * @param grain the largest range that is not split
+	 * @param body called as body(begin, end)
+	 */
+	void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)> &body)
+	{
+		if (n <= grain || size() == 1)
+		{
+			if (n > 0)
+			{
+				body(0, n);
+			}
+			return;
+		}
+		_Job job{body, {n}, std::max<size_t>(grain, 1), nullptr, {}};
+		size_t self = _self == this ? _selfIndex : 0;
+		_run(_Task{&job, 0, n}, self);
+		while (job.pending.load(std::memory_order_acquire) != 0)
+		{
+			_Task task{};
+			if (_take(self, task))
+			{
+				_run(task, self);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		if (job.error != nullptr)
+		{
+			std::rethrow_exception(job.error);
+		}
+	}
+
+private:
+	struct _Job
+	{
+		const std::function<void(size_t, size_t)> &body;
+		std::atomic<size_t> pending; // elements not processed yet
+		size_t grain;
+		std::exception_ptr error;
+		std::mutex errorLock;
+	};
+	
+	struct _Task
+	{
+		_Job *job;
+		size_t begin;
+		size_t end;
+	};
+	
+	struct _Queue
+	{
+		std::mutex lock;
+		std::deque<_Task> tasks;
+	};
+	
+	std::vector<std::unique_ptr<_Queue>> _queues;
+	std::vector<std::thread> _workers;
+	std::mutex _sleepLock;
+	std::condition_variable _wake;
+	bool _stop;
+	std::atomic<size_t> _queued; // tasks in all the queues
+	
+	static thread_local VLThreadPool *_self;
+	static thread_local size_t _selfIndex;
+	
+	/**
+	 * @brief split a task down to the grain, queueing the second halves, then run what is left
+	 * @param task the task
+	 * @param self the queue of the running thread
+	 */
+	void _run(_Task task, size_t self)
+	{
+		_Job &job = *task.job;
+		while (task.end - task.begin > job.grain)
+		{
+			size_t mid = task.begin + (task.end - task.begin) / 2;
+			_push(self, _Task{task.job, mid, task.end});
+			task.end = mid;
+		}
+		try
+		{
+			job.body(task.begin, task.end);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> guard(job.errorLock);
+			if (job.error == nullptr)
+			{
+				job.error = std::current_exception();
+			}
+		}
+		job.pending.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+	}
+	
+	/**
+	 * @brief queue a task and wake a sleeping worker
+	 * @param self the queue to put it in
+	 * @param task the task
+	 */
+	void _push(size_t self, _Task task)
+	{
+		{
+			std::lock_guard<std::mutex> guard(_sleepLock);
+			_queued++; // counted before it can be taken, so the count never drops below zero
+		}
+		{
+			std::lock_guard<std::mutex> guard(_queues[self]->lock);
+			_queues[self]->tasks.push_back(task);
+		}
+		_wake.notify_one();
+	}
+	
+	/**
+	 * @brief take a task - the newest of our own queue, or else the oldest of another one
+	 * @param self the queue of the running thread
+	 * @param task where to put the task
+	 * @return true if a task was taken
+	 */
+	bool _take(size_t self, _Task &task)
+	{
+		for (size_t k = 0; k < _queues.size(); k++)
+		{
+			_Queue &queue = *_queues[(self + k) % _queues.size()];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if (!queue.tasks.empty())
+			{
+				if (k == 0)
+				{
+					task = queue.tasks.back();
+					queue.tasks.pop_back();
+				}
+				else
+				{
+					task = queue.tasks.front();
+					queue.tasks.pop_front();
+				}
+				_queued--;
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	/**
+	 * @brief the loop of a worker thread
+	 * @param self the worker's queue
+	 */
+	void _work(size_t self)
+	{
+		_self = this;
+		_selfIndex = self;
+		while (true)
+		{
+			_Task task{};
+			if (_take(self, task))
+			{
+				_run(task, self);
+				continue;
+			}
+			std::unique_lock<std::mutex> guard(_sleepLock);
+			_wake.wait(guard, [this]
+			{
+				return _stop || _queued.load() > 0;
+			});
+			if (_stop)
+			{
+				return;
+			}
+		}
+	}
+};
+
+inline thread_local VLThreadPool *VLThreadPool::_self = nullptr;
+inline thread_local size_t VLThreadPool::_selfIndex = 0;
+
+/**
+ * parallel versions of the standard algorithms, over whole VLVectors. each one stays serial (and allocates
+ * nothing) when the vector is no larger than its inline capacity or than one grain
+ */
+namespace par
+{
+	/**
+	 * @brief the grain of a loop over a vector, n itself for inline-sized vectors so they stay serial
+	 * @param pool the pool
+	 * @param n the size of the vector
+	 * @param inlineCap the inline capacity of the vector
+	 * @return the grain
+	 */
+	inline size_t grainFor(VLThreadPool &pool, size_t n, size_t inlineCap)
+	{
+		return n <= inlineCap ? n : pool.grain(n);
+	}
+	
+	/**
+	 * @brief apply f to every element
+	 * @param vec the vector
+	 * @param f called as f(element)
+	 * @param pool the pool to run on
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator, class F>
+	void for_each(VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &vec, F f,
+				  VLThreadPool &pool = VLThreadPool::instance())
+	{
+		T *data = vec.data();
+		pool.parallelFor(vec.size(), grainFor(pool, vec.size(), StaticCapacity), [&](size_t begin, size_t end)
+		{
+			std::for_each(data + begin, data + end, f);
+		});
+	}
+	
+	/**
+	 * @brief dst becomes op applied to every element of src. dst is resized to the size of src first, so its
+	 * elements must be default constructible
+	 * @param src the source vector
+	 * @param dst the destination vector, may be src itself
+	 * @param op called as op(element)
+	 * @param pool the pool to run on
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator,
+			class U, unsigned long StaticCapacityU, class GrowthPolicyU, class ShrinkPolicyU, class AllocatorU,
+			class UnaryOp>
+	void transform(const VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &src,
+				   VLVector<U, StaticCapacityU, GrowthPolicyU, ShrinkPolicyU, AllocatorU> &dst, UnaryOp op,
+				   VLThreadPool &pool = VLThreadPool::instance())
+	{
+		dst.resize(src.size());
+		const T *from = src.data();
+		U *to = dst.data();
+		pool.parallelFor(src.size(), grainFor(pool, src.size(), StaticCapacity), [&](size_t begin, size_t end)
+		{
+			std::transform(from + begin, from + end, to + begin, op);
+		});
+	}
+	
+	/**
+	 * @brief dst becomes a copy of src, element by element. trivially copyable elements are copied into
+	 * unwritten storage, so every byte is written once. other elements are copy-assigned over the elements dst
+	 * already has, and dst is resized to the size of src first, so they must be default constructible
+	 * @param src the source vector
+	 * @param dst the destination vector, a capacity it has is kept
+	 * @param pool the pool to run on
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator,
+			unsigned long StaticCapacityU, class GrowthPolicyU, class ShrinkPolicyU, class AllocatorU>
+	void copy(const VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &src,
+			  VLVector<T, StaticCapacityU, GrowthPolicyU, ShrinkPolicyU, AllocatorU> &dst,
+			  VLThreadPool &pool = VLThreadPool::instance())
+	{
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			if (dst.size() > src.size())
+			{
+				dst.erase(dst.begin() + src.size(), dst.end());
+			}
+			else
+			{
+				dst.append_uninitialized(src.size() - dst.size());
+			}
+		}
+		else
+		{
+			static_assert(std::is_default_constructible<T>::value,
+						  "par::copy resizes the destination, its elements must be default constructible");
+			dst.resize(src.size());
+		}
+		const T *from = src.data();
+		T *to = dst.data();
+		pool.parallelFor(src.size(), grainFor(pool, src.size(), StaticCapacity), [&](size_t begin, size_t end)
+		{
+			std::copy(from + begin, from + end, to + begin);
+		});
+	}
+	
+	/**
+	 * @brief fold the elements with op, in no particular order or grouping - op must be associative and
+	 * commutative, like for std::reduce
+	 * @param vec the vector
+	 * @param init the value the fold starts with
+	 * @param op called as op(acc, element)
+	 * @param pool the pool to run on
+	 * @return the result
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator,
+			class Acc, class BinaryOp>
+	Acc reduce(const VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &vec, Acc init, BinaryOp op,
+			   VLThreadPool &pool = VLThreadPool::instance())
+	{
+		const T *data = vec.data();
+		std::mutex lock;
+		pool.parallelFor(vec.size(), grainFor(pool, vec.size(), StaticCapacity), [&](size_t begin, size_t end)
+		{
+			Acc part = data[begin];
+			for (size_t i = begin + 1; i < end; i++)
+			{
+				part = op(std::move(part), data[i]);
+			}
+			std::lock_guard<std::mutex> guard(lock);
+			init = op(std::move(init), std::move(part));
+		});
+		return init;
+	}
+	
+	/**
+	 * @brief sort the elements - the grains are sorted in parallel, then merged pairwise, a round of parallel
+	 * merges per doubling of the run length
+	 * @param vec the vector
+	 * @param comp the order, called as comp(a, b)
+	 * @param pool the pool to run on
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator,
+			class Compare = std::less<T>>
+	void sort(VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &vec, Compare comp = Compare(),
+			  VLThreadPool &pool = VLThreadPool::instance())
+	{
+		size_t n = vec.size();
+		size_t grain = grainFor(pool, n, StaticCapacity);
+		T *data = vec.data();
+		if (n <= grain || pool.size() == 1)
+		{
+			std::sort(data, data + n, comp);
+			return;
+		}
+		size_t runs = (n + grain - 1) / grain;
+		pool.parallelFor(runs, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t r = begin; r < end; r++)
+			{
+				std::sort(data + r * grain, data + std::min(n, (r + 1) * grain), comp);
+			}
+		});
+		for (size_t width = grain; width < n; width *= 2)
+		{
+			size_t pairs = (n + 2 * width - 1) / (2 * width);
+			pool.parallelFor(pairs, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t p = begin; p < end; p++)
+				{
+					size_t first = p * 2 * width;
+					size_t mid = std::min(n, first + width);
+					std::inplace_merge(data + first, data + mid, data + std::min(n, first + 2 * width), comp);
+				}
+			});
+		}
+	}
+}
+
+#endif // VLPARALLEL_HPP
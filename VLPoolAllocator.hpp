@@ -0,0 +1,230 @@
+/**
+ * @file    VLPoolAllocator.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Thread-local recycling of VLVector heap buffers.
+ */
+
+#ifndef VLPOOLALLOCATOR_HPP
+#define VLPOOLALLOCATOR_HPP
+
+#include <unordered_map>
+#include "VLVector.hpp"
+
+#define VL_POOL_MAX_CLASSES 32 // capacities a thread pools per element type, buffers of others go back to malloc
+
+/**
+ * @brief counters of one thread's pool, for one element type
+ */
+struct VLPoolStats
+{
+	size_t hits;     // allocations served from the pool
+	size_t misses;   // allocations that went to malloc
+	size_t recycled; // buffers given back to the pool
+	size_t released; // buffers given back to malloc, the pool was full or trimmed
+};
+
+/**
+ * @brief allocator that keeps freed heap buffers in a thread-local free list per capacity, and hands them to
+ * the next VLVector of the same element type that spills to that capacity. a VLVector only ever asks for the
+ * capacities its growth policy produces, so the free lists are in fact keyed by the policy's capacity classes.
+ * buffers may be freed on another thread than the one that took them, they join that thread's pool if it has
+ * a free list for their capacity and go back to malloc otherwise. once the thread's pool is destroyed at thread
+ * or program exit, buffers go straight to malloc. only the first VL_POOL_MAX_CLASSES capacities a thread asks for
+ * get a free list, so odd sizes cannot grow the pool without bound.
+ * @tparam T the type of the elements
+ * @tparam MaxCached the most buffers kept per capacity, extra ones go back to malloc
+ */
+template<class T, size_t MaxCached = 32>
+struct VLPoolAllocator
+{
+	typedef T value_type;
+	
+	template<class U>
+	struct rebind
+	{
+		typedef VLPoolAllocator<U, MaxCached> other;
+	};
+	
+	VLPoolAllocator() noexcept = default;
+	
+	template<class U>
+	VLPoolAllocator(const VLPoolAllocator<U, MaxCached> &) noexcept {}
+	
+	/**
+	 * @brief take a buffer for n elements, from the pool if one of that capacity is cached
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	T *allocate(size_t n)
+	{
+		if (_poolDead())
+		{
+			return _upstream().allocate(_slots(n));
+		}
+		_Pool &pool = _pool();
+		auto found = pool.lists.find(n);
+		if (found == pool.lists.end())
+		{
+			if (pool.lists.size() < VL_POOL_MAX_CLASSES) // made here so deallocate, which may not throw, never inserts
+			{
+				pool.lists.emplace(n, _FreeList());
+			}
+		}
+		else if (found->second.head != nullptr)
+		{
+			_FreeList &list = found->second;
+			_Node *node = list.head;
+			list.head = node->next;
+			list.count--;
+			pool.stats.hits++;
+			return reinterpret_cast<T *>(node);
+		}
+		pool.stats.misses++;
+		return _upstream().allocate(_slots(n));
+	}
+	
+	/**
+	 * @brief give a buffer back, it is cached unless the pool already holds MaxCached of its capacity
+	 * @param p pointer to the first slot
+	 * @param n number of slots
+	 */
+	void deallocate(T *p, size_t n) noexcept
+	{
+		if (_poolDead())
+		{
+			_upstream().deallocate(p, _slots(n));
+			return;
+		}
+		_Pool &pool = _pool();
+		auto found = pool.lists.find(n);
+		if (found == pool.lists.end() || found->second.count >= MaxCached)
+		{
+			pool.stats.released++;
+			_upstream().deallocate(p, _slots(n));
+			return;
+		}
+		_FreeList &list = found->second;
+		_Node *node = reinterpret_cast<_Node *>(p);
+		node->next = list.head;
+		list.head = node;
+		list.count++;
+		pool.stats.recycled++;
+	}
+	
+	/**
+	 * @brief getter for the counters of the calling thread's pool
+	 * @return the counters, all zero once the pool is destroyed
+	 */
+	static const VLPoolStats &stats()
+	{
+		static const VLPoolStats none{};
+		return _poolDead() ? none : _pool().stats;
+	}
+	
+	/**
+	 * @brief give every buffer cached by the calling thread back to malloc
+	 */
+	static void trim()
+	{
+		if (!_poolDead())
+		{
+			_pool().clear();
+		}
+	}
+
+private:
+	/**
+	 * a cached buffer holds the link to the next one in its first bytes
+	 */
+	struct _Node
+	{
+		_Node *next;
+	};
+	
+	struct _FreeList
+	{
+		_Node *head = nullptr;
+		size_t count = 0;
+	};
+	
+	struct _Pool
+	{
+		std::unordered_map<size_t, _FreeList> lists;
+		VLPoolStats stats{};
+		
+		/**
+		 * @brief free every cached buffer
+		 */
+		void clear() noexcept
+		{
+			for (auto &entry : lists)
+			{
+				while (entry.second.head != nullptr)
+				{
+					_Node *node = entry.second.head;
+					entry.second.head = node->next;
+					stats.released++;
+					_upstream().deallocate(reinterpret_cast<T *>(node), _slots(entry.first));
+				}
+				entry.second.count = 0;
+			}
+		}
+		
+		~_Pool()
+		{
+			clear();
+			_poolDead() = true;
+		}
+	};
+	
+	/**
+	 * @brief tells if the calling thread's pool is already destroyed, vectors that die later (statics, other
+	 * thread_locals) must not touch it. a trivial thread_local, so it is never destroyed itself
+	 * @return the flag
+	 */
+	static bool &_poolDead() noexcept
+	{
+		static thread_local bool dead = false;
+		return dead;
+	}
+	
+	/**
+	 * @brief the calling thread's pool
+	 * @return the pool
+	 */
+	static _Pool &_pool()
+	{
+		static thread_local _Pool pool;
+		return pool;
+	}
+	
+	/**
+	 * @brief the allocator the buffers really come from, its blocks are aligned for a _Node too
+	 * @return the allocator
+	 */
+	static VLAllocator<T> _upstream() { return VLAllocator<T>(); }
+	
+	/**
+	 * @brief number of slots to take for n elements, a buffer must be able to hold a _Node
+	 * @param n number of elements
+	 * @return number of slots
+	 */
+	static size_t _slots(size_t n) { return std::max(n, (sizeof(_Node) + sizeof(T) - 1) / sizeof(T)); }
+};
+
+template<class T, class U, size_t MaxCached>
+bool operator==(const VLPoolAllocator<T, MaxCached> &, const VLPoolAllocator<U, MaxCached> &) noexcept { return true; }
+
+template<class T, class U, size_t MaxCached>
+bool operator!=(const VLPoolAllocator<T, MaxCached> &, const VLPoolAllocator<U, MaxCached> &) noexcept { return false; }
+
+/**
+ * @brief VLVector whose heap buffers are recycled through the calling thread's pool
+ */
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+		class ShrinkPolicy = ShrinkBelowWatermark<>>
+using PooledVLVector = VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, VLPoolAllocator<T>>;
+
+#endif // VLPOOLALLOCATOR_HPP
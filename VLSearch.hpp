@@ -0,0 +1,343 @@
+/**
+ * @file    VLSearch.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   SIMD search kernels behind VLVector::find, count and find_first_of.
+ */
+
+#ifndef VLSEARCH_HPP
+#define VLSEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define VL_SIMD_X86 1
+#include <immintrin.h>
+#define VL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VL_SIMD_X86 0
+#endif
+
+#define VL_SEARCH_MAX_NEEDLES 8
+
+/**
+ * @brief search kernels for elements of K bytes, compared by their bit patterns. every kernel looks at the
+ * first `bytes` bytes of p, and may load (but ignores) anything up to `readable` bytes, which lets a tail
+ * shorter than a register, or a whole inline buffer, be searched with a single masked load.
+ * the kernels answer either the index of the first element equal to one of the needles (the number of
+ * elements if there is none), or the number of elements equal to one of them
+ * @tparam K the size of the elements
+ */
+template<size_t K>
+struct VLSearchKernels
+{
+	/**
+	 * @brief the plain loop, for what no register can load
+	 * @param p the elements
+	 * @param bytes their size in bytes
+	 * @param needles the bit patterns to look for
+	 * @param m the number of needles
+	 * @param counting count the matches instead of finding the first one
+	 * @return index of the first match or the number of matches
+	 */
+	static size_t scalar(const unsigned char *p, size_t bytes, const uint64_t *needles, size_t m, bool counting)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < bytes; i += K)
+		{
+			uint64_t val = 0;
+			std::memcpy(&val, p + i, K);
+			bool hit = false;
+			for (size_t j = 0; j < m && !hit; j++)
+			{
+				hit = val == needles[j];
+			}
+			if (hit && !counting)
+			{
+				return i / K;
+			}
+			found += hit;
+		}
+		return counting ? found : bytes / K;
+	}
+
+#if VL_SIMD_X86
+	/**
+	 * @brief a register with val in every element
+	 */
+	static __m128i _splat128(uint64_t val)
+	{
+		switch (K)
+		{
+			case 1:
+				return _mm_set1_epi8((char) val);
+			case 2:
+				return _mm_set1_epi16((short) val);
+			case 4:
+				return _mm_set1_epi32((int) val);
+			default:
+				return _mm_set1_epi64x((long long) val);
+		}
+	}
+	
+	/**
+	 * @brief compare element by element, all the bytes of an equal element are set
+	 */
+	static __m128i _eq128(__m128i a, __m128i b)
+	{
+		switch (K)
+		{
+			case 1:
+				return _mm_cmpeq_epi8(a, b);
+			case 2:
+				return _mm_cmpeq_epi16(a, b);
+			case 4:
+				return _mm_cmpeq_epi32(a, b);
+			default:
+			{
+				// no 64-bit compare in SSE2, both halves have to match
+				__m128i halves = _mm_cmpeq_epi32(a, b);
+				return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+			}
+		}
+	}
+	
+	/**
+	 * @brief the SSE2 kernel, 16 bytes per load
+	 * @param p the elements
+	 * @param bytes their size in bytes
+	 * @param readable how many bytes from p may be loaded
+	 * @param needles the bit patterns to look for
+	 * @param m the number of needles
+	 * @param counting count the matches instead of finding the first one
+	 * @return index of the first match or the number of matches
+	 */
+	static size_t sse2(const unsigned char *p, size_t bytes, size_t readable, const uint64_t *needles, size_t m,
+					   bool counting)
+	{
+		__m128i keys[VL_SEARCH_MAX_NEEDLES];
+		for (size_t j = 0; j < m; j++)
+		{
+			keys[j] = _splat128(needles[j]);
+		}
+		size_t found = 0; // matching bytes, K per element
+		size_t i = 0;
+		for (; i < bytes && i + 16 <= readable; i += 16)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+			__m128i hit = _eq128(block, keys[0]);
+			for (size_t j = 1; j < m; j++)
+			{
+				hit = _mm_or_si128(hit, _eq128(block, keys[j]));
+			}
+			uint32_t mask = (uint32_t) _mm_movemask_epi8(hit);
+			if (bytes - i < 16) // the load went past the last element
+			{
+				mask &= (1u << (bytes - i)) - 1;
+			}
+			if (counting)
+			{
+				found += __builtin_popcount(mask);
+			}
+			else if (mask != 0)
+			{
+				return (i + __builtin_ctz(mask)) / K;
+			}
+		}
+		if (i >= bytes)
+		{
+			return counting ? found / K : bytes / K;
+		}
+		size_t tail = scalar(p + i, bytes - i, needles, m, counting);
+		return counting ? found / K + tail : i / K + tail;
+	}
+	
+	/**
+	 * @brief a register with val in every element
+	 */
+	VL_TARGET_AVX2 static __m256i _splat256(uint64_t val)
+	{
+		switch (K)
+		{
+			case 1:
+				return _mm256_set1_epi8((char) val);
+			case 2:
+				return _mm256_set1_epi16((short) val);
+			case 4:
+				return _mm256_set1_epi32((int) val);
+			default:
+				return _mm256_set1_epi64x((long long) val);
+		}
+	}
+	
+	/**
+	 * @brief compare element by element, all the bytes of an equal element are set
+	 */
+	VL_TARGET_AVX2 static __m256i _eq256(__m256i a, __m256i b)
+	{
+		switch (K)
+		{
+			case 1:
+				return _mm256_cmpeq_epi8(a, b);
+			case 2:
+				return _mm256_cmpeq_epi16(a, b);
+			case 4:
+				return _mm256_cmpeq_epi32(a, b);
+			default:
+				return _mm256_cmpeq_epi64(a, b);
+		}
+	}
+	
+	/**
+	 * @brief the AVX2 kernel, 32 bytes per load. what is left when no 32-byte load fits goes to the SSE2 kernel
+	 * @param p the elements
+	 * @param bytes their size in bytes
+	 * @param readable how many bytes from p may be loaded
+	 * @param needles the bit patterns to look for
+	 * @param m the number of needles
+	 * @param counting count the matches instead of finding the first one
+	 * @return index of the first match or the number of matches
+	 */
+	VL_TARGET_AVX2 static size_t avx2(const unsigned char *p, size_t bytes, size_t readable, const uint64_t *needles,
+									  size_t m, bool counting)
+	{
+		__m256i keys[VL_SEARCH_MAX_NEEDLES];
+		for (size_t j = 0; j < m; j++)
+		{
+			keys[j] = _splat256(needles[j]);
+		}
+		size_t found = 0; // matching bytes, K per element
+		size_t i = 0;
+		for (; i < bytes && i + 32 <= readable; i += 32)
+		{
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+			__m256i hit = _eq256(block, keys[0]);
+			for (size_t j = 1; j < m; j++)
+			{
+				hit = _mm256_or_si256(hit, _eq256(block, keys[j]));
+			}
+			uint32_t mask = (uint32_t) _mm256_movemask_epi8(hit);
+			if (bytes - i < 32) // the load went past the last element
+			{
+				mask &= (1u << (bytes - i)) - 1;
+			}
+			if (counting)
+			{
+				found += __builtin_popcount(mask);
+			}
+			else if (mask != 0)
+			{
+				return (i + __builtin_ctz(mask)) / K;
+			}
+		}
+		if (i >= bytes)
+		{
+			return counting ? found / K : bytes / K;
+		}
+		size_t tail = sse2(p + i, bytes - i, readable - i, needles, m, counting);
+		return counting ? found / K + tail : i / K + tail;
+	}
+	
+	/**
+	 * @brief checked once - can this CPU run the AVX2 kernel
+	 * @return true if it can
+	 */
+	static bool hasAvx2()
+	{
+		static const bool has = __builtin_cpu_supports("avx2");
+		return has;
+	}
+#endif
+	
+	/**
+	 * @brief run the best kernel this CPU has
+	 * @param p the elements
+	 * @param bytes their size in bytes
+	 * @param readable how many bytes from p may be loaded
+	 * @param needles the bit patterns to look for
+	 * @param m the number of needles, at most VL_SEARCH_MAX_NEEDLES
+	 * @param counting count the matches instead of finding the first one
+	 * @return index of the first match or the number of matches
+	 */
+	static size_t run(const unsigned char *p, size_t bytes, size_t readable, const uint64_t *needles, size_t m,
+					  bool counting)
+	{
+#if VL_SIMD_X86
+		if (hasAvx2())
+		{
+			return avx2(p, bytes, readable, needles, m, counting);
+		}
+		return sse2(p, bytes, readable, needles, m, counting);
+#else
+		(void) readable;
+		return scalar(p, bytes, needles, m, counting);
+#endif
+	}
+};
+
+/**
+ * @brief the search kernels for elements of type T. integral elements compare by their bit patterns, so only
+ * they are searched by the kernels, any other type goes through the standard algorithms
+ * @tparam T the type of the elements
+ */
+template<class T>
+struct VLSearch
+{
+	static constexpr bool simd = std::is_integral<T>::value &&
+								 (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+	
+	/**
+	 * @brief index of the first element equal to one of the needles
+	 * @param p the elements
+	 * @param n their number
+	 * @param readable how many elements from p may be loaded, at least n
+	 * @param needles the values to look for
+	 * @param m their number, at most VL_SEARCH_MAX_NEEDLES
+	 * @return the index, n if there is none
+	 */
+	static size_t find(const T *p, size_t n, size_t readable, const T *needles, size_t m)
+	{
+		uint64_t keys[VL_SEARCH_MAX_NEEDLES];
+		_keys(needles, m, keys);
+		return VLSearchKernels<sizeof(T)>::run(reinterpret_cast<const unsigned char *>(p), n * sizeof(T),
+											   readable * sizeof(T), keys, m, false);
+	}
+	
+	/**
+	 * @brief number of elements equal to val
+	 * @param p the elements
+	 * @param n their number
+	 * @param readable how many elements from p may be loaded, at least n
+	 * @param val the value to look for
+	 * @return the count
+	 */
+	static size_t count(const T *p, size_t n, size_t readable, const T &val)
+	{
+		uint64_t keys[1];
+		_keys(&val, 1, keys);
+		return VLSearchKernels<sizeof(T)>::run(reinterpret_cast<const unsigned char *>(p), n * sizeof(T),
+											   readable * sizeof(T), keys, 1, true);
+	}
+
+private:
+	/**
+	 * @brief the bit patterns of the needles, in the low bytes of a uint64_t
+	 * @param needles the values to look for
+	 * @param m their number
+	 * @param keys where to put the patterns
+	 */
+	static void _keys(const T *needles, size_t m, uint64_t *keys)
+	{
+		for (size_t j = 0; j < m; j++)
+		{
+			keys[j] = 0;
+			std::memcpy(&keys[j], &needles[j], sizeof(T));
+		}
+	}
+};
+
+#endif // VLSEARCH_HPP
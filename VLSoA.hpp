@@ -0,0 +1,967 @@
+/**
+ * @file    VLSoA.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Structure-of-arrays Virtual Length Vector - one array per field of the rows.
+ */
+
+#ifndef VLSOA_HPP
+#define VLSOA_HPP
+
+#include <tuple>
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+
+/**
+ * @brief a contiguous run of elements that belongs to someone else, it is what VLSoA hands out for a field
+ * @tparam T the type of the elements, const for a read-only span
+ */
+template<class T>
+class VLSpan
+{
+public:
+	typedef T *iterator;
+	typedef typename std::remove_const<T>::type value_type;
+	
+	VLSpan(T *data, size_t size) : _data(data), _size(size) {}
+	
+	/**
+	 * @brief getter for the first element
+	 * @return pointer to the first element
+	 */
+	T *data() const noexcept { return _data; }
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const noexcept { return _size; }
+	
+	/**
+	 * @brief checks if the span is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const noexcept { return _size == 0; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	T &operator[](const size_t &idx) const { return _data[idx]; }
+	
+	/**
+	 * @brief
+	 * @return iterator to the span's begin
+	 */
+	iterator begin() const { return _data; }
+	
+	/**
+	 * @brief
+	 * @return iterator to the span's end
+	 */
+	iterator end() const { return _data + _size; }
+
+private:
+	T *_data;
+	size_t _size;
+};
+
+/**
+ * @brief a row of a VLSoA - references to its fields, which live in different arrays. assigning to a row
+ * assigns its fields, it converts to the row's tuple, and swap swaps the fields, so the STL algorithms can
+ * move rows around through it. structured bindings give the fields themselves
+ * @tparam Refs a reference type per field, const references for a read-only row
+ */
+template<class... Refs>
+class VLSoARef
+{
+public:
+	typedef std::tuple<typename std::decay<Refs>::type...> value_type;
+	
+	explicit VLSoARef(Refs... refs) : _refs(refs...) {}
+	
+	VLSoARef(const VLSoARef &other) = default;
+	
+	/**
+	 * @brief a mutable row converts to a read-only one
+	 */
+	template<class... OtherRefs,
+			class = typename std::enable_if<std::is_constructible<std::tuple<Refs...>,
+																 const std::tuple<OtherRefs...> &>::value>::type>
+	VLSoARef(const VLSoARef<OtherRefs...> &other) : _refs(other.tie()) {}
+	
+	/**
+	 * @brief copy the fields of another row into this one's
+	 * @param rhs right hand side
+	 * @return reference to this row
+	 */
+	VLSoARef &operator=(const VLSoARef &rhs)
+	{
+		_refs = rhs._refs;
+		return *this;
+	}
+	
+	/**
+	 * @brief copy the fields of another row into this one's
+	 * @param rhs right hand side
+	 * @return reference to this row
+	 */
+	template<class... OtherRefs>
+	VLSoARef &operator=(const VLSoARef<OtherRefs...> &rhs)
+	{
+		_refs = rhs.tie();
+		return *this;
+	}
+	
+	/**
+	 * @brief copy the fields of a tuple into this row's
+	 * @param rhs right hand side
+	 * @return reference to this row
+	 */
+	VLSoARef &operator=(const value_type &rhs)
+	{
+		_refs = rhs;
+		return *this;
+	}
+	
+	/**
+	 * @brief move the fields of a tuple into this row's
+	 * @param rhs right hand side
+	 * @return reference to this row
+	 */
+	VLSoARef &operator=(value_type &&rhs)
+	{
+		_refs = std::move(rhs);
+		return *this;
+	}
+	
+	/**
+	 * @brief copy the row out
+	 * @return a tuple with copies of the fields
+	 */
+	operator value_type() const { return value_type(_refs); }
+	
+	/**
+	 * @brief access a field
+	 * @tparam I the field
+	 * @return reference to the field
+	 */
+	template<size_t I>
+	typename std::tuple_element<I, std::tuple<Refs...>>::type get() const { return std::get<I>(_refs); }
+	
+	/**
+	 * @brief the references to the fields
+	 * @return the references
+	 */
+	const std::tuple<Refs...> &tie() const noexcept { return _refs; }
+	
+	/**
+	 * @brief exchange the fields of two rows
+	 * @param lhs left hand side
+	 * @param rhs right hand side
+	 */
+	friend void swap(VLSoARef lhs, VLSoARef rhs) { lhs._swap(rhs, std::index_sequence_for<Refs...>()); }
+	
+	friend bool operator==(const VLSoARef &lhs, const VLSoARef &rhs) { return lhs._refs == rhs._refs; }
+	
+	friend bool operator==(const VLSoARef &lhs, const value_type &rhs) { return lhs._refs == rhs; }
+	
+	friend bool operator==(const value_type &lhs, const VLSoARef &rhs) { return lhs == rhs._refs; }
+	
+	friend bool operator!=(const VLSoARef &lhs, const VLSoARef &rhs) { return !(lhs == rhs); }
+	
+	friend bool operator!=(const VLSoARef &lhs, const value_type &rhs) { return !(lhs == rhs); }
+	
+	friend bool operator!=(const value_type &lhs, const VLSoARef &rhs) { return !(lhs == rhs); }
+	
+	friend bool operator<(const VLSoARef &lhs, const VLSoARef &rhs) { return lhs._refs < rhs._refs; }
+	
+	friend bool operator<(const VLSoARef &lhs, const value_type &rhs) { return lhs._refs < rhs; }
+	
+	friend bool operator<(const value_type &lhs, const VLSoARef &rhs) { return lhs < rhs._refs; }
+
+private:
+	std::tuple<Refs...> _refs;
+	
+	/**
+	 * @brief exchange the fields with another row
+	 * @param other the other row
+	 */
+	template<size_t... I>
+	void _swap(VLSoARef &other, std::index_sequence<I...>)
+	{
+		using std::swap;
+		(swap(std::get<I>(_refs), std::get<I>(other._refs)), ...);
+	}
+};
+
+/**
+ * @brief access a field of a row like std::get does for the row's tuple, so one generic comparator takes both
+ * (`using std::get;` brings the two together)
+ * @tparam I the field
+ * @param row the row
+ * @return reference to the field
+ */
+template<size_t I, class... Refs>
+typename std::tuple_element<I, std::tuple<Refs...>>::type get(const VLSoARef<Refs...> &row)
+{
+	return row.template get<I>();
+}
+
+namespace std
+{
+	template<class... Refs>
+	struct tuple_size<VLSoARef<Refs...>> : std::integral_constant<size_t, sizeof...(Refs)>
+	{
+	};
+	
+	template<size_t I, class... Refs>
+	struct tuple_element<I, VLSoARef<Refs...>>
+	{
+		typedef typename std::tuple_element<I, std::tuple<Refs...>>::type type;
+	};
+}
+
+/**
+ * @brief a VLVector of rows stored as a structure of arrays - every field has its own inline array of
+ * StaticCapacity slots and spills to its own heap buffer, all of them moving together, so a loop over one
+ * field reads only that field. field<I>() is a contiguous span of a field, the rows are seen through
+ * VLSoARef proxies
+ * @tparam StaticCapacity the number of inline rows
+ * @tparam GrowthPolicy decides the heap capacity when the rows outgrow their buffers (see GrowOneAndHalf)
+ * @tparam ShrinkPolicy decides when the heap buffers are given back (see ShrinkBelowWatermark)
+ * @tparam Fields the types of the fields, moving one may not throw
+ */
+template<unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class... Fields>
+class BasicVLSoA
+{
+	static_assert(sizeof...(Fields) > 0, "a row needs at least one field");
+	static_assert(std::conjunction<std::is_nothrow_move_constructible<Fields>...>::value,
+				  "a row is spread over several buffers, a field that fails to move could not be rolled back");
+
+private:
+	template<size_t I>
+	using _Field = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+	
+	typedef std::tuple<Fields *...> _Arrays;
+	
+	/**
+	 * raw inline storage of a field
+	 */
+	template<class F>
+	struct _Slots
+	{
+		alignas(F) unsigned char bytes[StaticCapacity * sizeof(F)];
+	};
+	
+	_Arrays _data; // the active buffers - the inline ones, or the heap ones once we spilled
+	size_t _size;
+	size_t _cap; // StaticCapacity while inline, the capacity of the heap buffers after
+	std::tuple<_Slots<Fields>...> stackArrs; // only [0, _size) of each is alive
+	
+	/**
+	 * the bytes of a row, what the growth policy sees as the element size
+	 */
+	static constexpr size_t _rowBytes = (sizeof(Fields) + ...);
+	
+	/**
+	 * @brief call func once per field with std::integral_constant<size_t, I>
+	 * @param func the callable
+	 */
+	template<class Func>
+	static void _each(Func &&func) { _eachOf(func, std::index_sequence_for<Fields...>()); }
+	
+	template<class Func, size_t... I>
+	static void _eachOf(Func &func, std::index_sequence<I...>) { (func(std::integral_constant<size_t, I>()), ...); }
+	
+	/**
+	 * @brief typed view of the inline storage
+	 * @return the inline arrays
+	 */
+	_Arrays _stack() noexcept { return _stackOf(std::index_sequence_for<Fields...>()); }
+	
+	template<size_t... I>
+	_Arrays _stackOf(std::index_sequence<I...>) noexcept
+	{
+		return _Arrays(reinterpret_cast<_Field<I> *>(std::get<I>(stackArrs).bytes)...);
+	}
+	
+	/**
+	 * @brief checks where the rows live
+	 * @return true if they are in heap buffers, false if they are inline
+	 */
+	bool _onHeap() const noexcept { return _cap > StaticCapacity; }
+	
+	/**
+	 * @brief take a heap buffer of n slots per field, all or none
+	 * @param n number of slots
+	 * @return the buffers
+	 */
+	static _Arrays _allocate(size_t n)
+	{
+		_Arrays arrs;
+		size_t done = 0;
+		try
+		{
+			_each([&](auto i) {
+				constexpr size_t I = decltype(i)::value;
+				std::get<I>(arrs) = VLAllocator<_Field<I>>().allocate(n);
+				done++;
+			});
+		}
+		catch (...)
+		{
+			_each([&](auto i) {
+				constexpr size_t I = decltype(i)::value;
+				if (I < done)
+				{
+					VLAllocator<_Field<I>>().deallocate(std::get<I>(arrs), n);
+				}
+			});
+			throw;
+		}
+		return arrs;
+	}
+	
+	/**
+	 * @brief give back heap buffers that were taken with _allocate
+	 * @param arrs the buffers
+	 * @param n their number of slots
+	 */
+	static void _deallocate(_Arrays const &arrs, size_t n) noexcept
+	{
+		_each([&](auto i) {
+			constexpr size_t I = decltype(i)::value;
+			VLAllocator<_Field<I>>().deallocate(std::get<I>(arrs), n);
+		});
+	}
+	
+	/**
+	 * @brief move n rows to uninitialized slots and destroy the originals, bytewise for trivially relocatable
+	 * fields
+	 * @param from the rows to move
+	 * @param n their number
+	 * @param to where they go
+	 */
+	static void _relocate(_Arrays const &from, size_t n, _Arrays const &to) noexcept
+	{
+		_each([&](auto i) {
+			constexpr size_t I = decltype(i)::value;
+			typedef _Field<I> F;
+			if constexpr (IsTriviallyRelocatable<F>::value)
+			{
+				if (n != 0)
+				{
+					std::memcpy(static_cast<void *>(std::get<I>(to)), static_cast<const void *>(std::get<I>(from)),
+								n * sizeof(F));
+				}
+			}
+			else
+			{
+				std::uninitialized_move_n(std::get<I>(from), n, std::get<I>(to));
+				std::destroy_n(std::get<I>(from), n);
+			}
+		});
+	}
+	
+	/**
+	 * @brief destroy the rows [first, last)
+	 * @param first the first row
+	 * @param last past the last row
+	 */
+	void _destroy(size_t first, size_t last) noexcept
+	{
+		_each([&](auto i) {
+			constexpr size_t I = decltype(i)::value;
+			std::destroy(std::get<I>(_data) + first, std::get<I>(_data) + last);
+		});
+	}
+	
+	/**
+	 * @brief move the rows to buffers of newCap slots, the inline ones if newCap is StaticCapacity
+	 * @param newCap the new capacity, at least _size
+	 */
+	void _moveTo(size_t newCap)
+	{
+		_Arrays arrs = newCap > StaticCapacity ? _allocate(newCap) : _stack();
+		_relocate(_data, _size, arrs);
+		if (_onHeap())
+		{
+			_deallocate(_data, _cap);
+		}
+		_data = arrs;
+		_cap = newCap;
+	}
+	
+	/**
+	 * @brief the capacity for a new size - see VLVector::_capFor
+	 * @param s the new size
+	 * @return the capacity
+	 */
+	size_t _capFor(size_t s) const
+	{
+		if (s <= _cap)
+		{
+			return _cap;
+		}
+		return std::max(s, GrowthPolicy::grow(s, _cap, _rowBytes));
+	}
+	
+	/**
+	 * @brief grow the buffers for a new size, or give memory back if the shrink policy says so - the same
+	 * rules as VLVector::_reCap
+	 * @param newSize the size the vector is about to have
+	 */
+	void _reCap(size_t newSize)
+	{
+		if (newSize > _cap)
+		{
+			_moveTo(_capFor(newSize));
+		}
+		else if (_onHeap() && ShrinkPolicy::shrink(newSize, _cap))
+		{
+			if (newSize <= StaticCapacity)
+			{
+				_moveTo(StaticCapacity);
+			}
+			else
+			{
+				size_t newCap = std::max(newSize, GrowthPolicy::grow(newSize, newSize, _rowBytes));
+				if (newCap < _cap)
+				{
+					_moveTo(newCap);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * @brief destroy the rows from index count on, the shrink policy may then give memory back
+	 * @param count the new size, at most _size
+	 */
+	void _truncate(size_t count)
+	{
+		_destroy(count, _size);
+		_size = count;
+		_reCap(_size);
+	}
+	
+	/**
+	 * @brief construct the fields of a row from one argument each, a field that throws takes the ones built
+	 * before it down
+	 * @param idx the slot, it must have room
+	 * @param args the constructor argument of every field
+	 */
+	template<class... Args>
+	void _build(size_t idx, Args &&... args)
+	{
+		_buildOf(idx, std::index_sequence_for<Fields...>(), std::forward<Args>(args)...);
+	}
+	
+	template<size_t... I, class... Args>
+	void _buildOf(size_t idx, std::index_sequence<I...>, Args &&... args)
+	{
+		size_t built = 0;
+		try
+		{
+			((new(std::get<I>(_data) + idx) Fields(std::forward<Args>(args)), built++), ...);
+		}
+		catch (...)
+		{
+			((I < built ? std::destroy_at(std::get<I>(_data) + idx) : void()), ...);
+			throw;
+		}
+	}
+	
+	/**
+	 * @brief construct the rows [_size, _size + n) field by field, a field that throws takes the ones built
+	 * before it down
+	 * @param n the number of rows, they must have room
+	 * @param fill called with a field number and its first new slot, constructs n elements there
+	 */
+	template<class Fill>
+	void _fill(size_t n, Fill &&fill)
+	{
+		size_t built = 0;
+		try
+		{
+			_each([&](auto i) {
+				fill(i, std::get<decltype(i)::value>(_data) + _size);
+				built++;
+			});
+		}
+		catch (...)
+		{
+			_each([&](auto i) {
+				constexpr size_t I = decltype(i)::value;
+				if (I < built)
+				{
+					std::destroy_n(std::get<I>(_data) + _size, n);
+				}
+			});
+			throw;
+		}
+		_size += n;
+	}
+	
+	/**
+	 * @brief the proxy of a row
+	 * @param idx the row
+	 * @return the proxy
+	 */
+	template<class Row, size_t... I>
+	Row _row(size_t idx, std::index_sequence<I...>) const { return Row(std::get<I>(_data)[idx]...); }
+	
+	/**
+	 * @brief give the heap buffers of other to this vector or move its inline rows here, we must be empty on
+	 * the stack, and other is left that way
+	 * @param other the vector to take from
+	 */
+	void _steal(BasicVLSoA &other) noexcept
+	{
+		if (other._onHeap())
+		{
+			_data = other._data;
+			_cap = other._cap;
+			other._data = other._stack();
+			other._cap = StaticCapacity;
+		}
+		else
+		{
+			_relocate(other._data, other._size, _data);
+		}
+		_size = other._size;
+		other._size = 0;
+	}
+	
+	/**
+	 * @brief destroy every row and give the heap buffers back, the vector is left empty on the stack
+	 */
+	void _release() noexcept
+	{
+		_destroy(0, _size);
+		_size = 0;
+		if (_onHeap())
+		{
+			_deallocate(_data, _cap);
+			_data = _stack();
+			_cap = StaticCapacity;
+		}
+	}
+
+public:
+	/**
+	 * iterator traits
+	 */
+	typedef std::tuple<Fields...> value_type;
+	typedef VLSoARef<Fields &...> reference;
+	typedef VLSoARef<const Fields &...> const_reference;
+	typedef VLIndexIterator<BasicVLSoA, value_type, reference> iterator;
+	typedef VLIndexIterator<const BasicVLSoA, const value_type, const_reference> const_iterator;
+	typedef std::ptrdiff_t difference_type;
+	
+	/**
+	 * @brief default constructor - creates a size 0 vector, no element is constructed
+	 */
+	BasicVLSoA() : _data(_stack()), _size(0), _cap(StaticCapacity) {}
+	
+	/**
+	 * @brief copy constractor - allocates once and copies field by field
+	 * @param other the vector to be copied into a new vector
+	 */
+	BasicVLSoA(BasicVLSoA const &other) : BasicVLSoA()
+	{
+		reserve(other._size);
+		_copy(other);
+	}
+	
+	/**
+	 * @brief move constractor - steals the heap buffers in O(1), inline rows are moved. other is left empty
+	 * @param other the vector to be moved into a new vector
+	 */
+	BasicVLSoA(BasicVLSoA &&other) noexcept : BasicVLSoA() { _steal(other); }
+	
+	/**
+	 * @brief destructor - destroys the rows and gives the heap buffers back
+	 */
+	~BasicVLSoA() { _release(); }
+	
+	/**
+	 * @brief define operator '=' for vector assignment, our buffers are reused if the rows fit
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	BasicVLSoA &operator=(BasicVLSoA const &rhs)
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		_destroy(0, _size);
+		_size = 0;
+		reserve(rhs._size);
+		_copy(rhs);
+		return *this;
+	}
+	
+	/**
+	 * @brief define operator '=' for vector move assignment, rhs is left empty
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	BasicVLSoA &operator=(BasicVLSoA &&rhs) noexcept
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		_release();
+		_steal(rhs);
+		return *this;
+	}
+	
+	/**
+	 * @brief exchange the content of two vectors, heap buffers change hands in O(1)
+	 * @param other the vector to swap with
+	 */
+	void swap(BasicVLSoA &other) noexcept
+	{
+		BasicVLSoA tmp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const { return _size; }
+	
+	/**
+	 * @brief getter for capacity attribute, the same for every field
+	 * @return capacity
+	 */
+	size_t capacity() const { return _cap; }
+	
+	/**
+	 * @brief checks if the vector is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return _size == 0; }
+	
+	/**
+	 * @brief add a row at the end of the vector
+	 * @param add the row to add
+	 */
+	void push_back(const value_type &add)
+	{
+		std::apply([this](const Fields &... fields) { emplace_back(fields...); }, add);
+	}
+	
+	/**
+	 * @brief add a row at the end of the vector by moving its fields
+	 * @param add the row to add
+	 */
+	void push_back(value_type &&add)
+	{
+		std::apply([this](Fields &... fields) { emplace_back(std::move(fields)...); }, add);
+	}
+	
+	/**
+	 * @brief build a row at the end of the vector
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor argument of every field, in order
+	 * @return the new row
+	 */
+	template<class... Args>
+	reference emplace_back(Args &&... args)
+	{
+		static_assert(sizeof...(Args) == sizeof...(Fields), "a row is built from one argument per field");
+		if (_size == _cap) // the arguments may be fields of ours, build the row before the buffers move
+		{
+			value_type toAdd(std::forward<Args>(args)...);
+			_reCap(_size + 1);
+			std::apply([this](Fields &... fields) { _build(_size, std::move(fields)...); }, toAdd);
+		}
+		else
+		{
+			_build(_size, std::forward<Args>(args)...);
+		}
+		_size++;
+		return (*this)[_size - 1];
+	}
+	
+	/**
+	 * @brief remove the last row in the vector if exists
+	 */
+	void pop_back()
+	{
+		if (_size == 0)
+		{
+			return;
+		}
+		_truncate(_size - 1);
+	}
+	
+	/**
+	 * @brief empty the vector, release allocated memory if the shrink policy says so
+	 */
+	void clear() { _truncate(0); }
+	
+	/**
+	 * @brief make room for at least n rows with a single allocation per field, if they do not fit the current
+	 * buffers. never shrinks
+	 * @param n the number of rows the caller is about to hold
+	 */
+	void reserve(size_t n)
+	{
+		if (n > _cap)
+		{
+			_moveTo(n);
+		}
+	}
+	
+	/**
+	 * @brief change the size - the fields of new rows are value-initialized, removed rows are destroyed
+	 * @param count the new size
+	 */
+	void resize(size_t count)
+	{
+		if (count > _size)
+		{
+			_reCap(count);
+			_fill(count - _size, [&](auto, auto *first) { std::uninitialized_value_construct_n(first, count - _size); });
+		}
+		else
+		{
+			_truncate(count);
+		}
+	}
+	
+	/**
+	 * @brief give back the unused capacity - the rows go back to the stack if they fit there, otherwise to
+	 * heap buffers of exactly size() slots. does nothing if the shrink policy ignores requests
+	 */
+	void shrink_to_fit()
+	{
+		if (!ShrinkPolicy::onRequest || !_onHeap() || _cap == _size)
+		{
+			return;
+		}
+		_moveTo(std::max(_size, (size_t) StaticCapacity));
+	}
+	
+	/**
+	 * @brief the values of one field, contiguous in memory
+	 * @tparam I the field
+	 * @return span over the field of every row
+	 */
+	template<size_t I>
+	VLSpan<_Field<I>> field() noexcept { return VLSpan<_Field<I>>(std::get<I>(_data), _size); }
+	
+	/**
+	 * @brief the values of one field, contiguous in memory
+	 * @tparam I the field
+	 * @return read-only span over the field of every row
+	 */
+	template<size_t I>
+	VLSpan<const _Field<I>> field() const noexcept { return VLSpan<const _Field<I>>(std::get<I>(_data), _size); }
+	
+	/**
+	 * @brief Gives full access to the array of one field
+	 * @tparam I the field
+	 * @return pointer to the field of the first row
+	 */
+	template<size_t I>
+	_Field<I> *data() noexcept { return std::get<I>(_data); }
+	
+	/**
+	 * @brief Gives read-only access to the array of one field
+	 * @tparam I the field
+	 * @return pointer to the field of the first row
+	 */
+	template<size_t I>
+	const _Field<I> *data() const noexcept { return std::get<I>(_data); }
+	
+	/**
+	 * @brief access the requested row
+	 * @param idx index to access
+	 * @return proxy of the row
+	 */
+	reference operator[](const size_t &idx) { return _row<reference>(idx, std::index_sequence_for<Fields...>()); }
+	
+	/**
+	 * @brief access the requested row
+	 * @param idx index to access
+	 * @return read-only proxy of the row
+	 */
+	const_reference operator[](const size_t &idx) const
+	{
+		return _row<const_reference>(idx, std::index_sequence_for<Fields...>());
+	}
+	
+	/**
+	 * @brief access the requested row, while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return proxy of the row
+	 */
+	reference at(const size_t idx)
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief access the requested row, while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return read-only proxy of the row
+	 */
+	const_reference at(const size_t idx) const
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief erase the rows in the range [first, last)
+	 * @param first iterator to the first row to erase
+	 * @param last iterator past the last row to erase
+	 * @return iterator to the row that followed the erased ones
+	 */
+	iterator erase(const_iterator const &first, const_iterator const &last)
+	{
+		size_t from = first.index();
+		size_t to = last.index();
+		if (from != to)
+		{
+			_each([&](auto i) {
+				constexpr size_t I = decltype(i)::value;
+				std::move(std::get<I>(_data) + to, std::get<I>(_data) + _size, std::get<I>(_data) + from);
+			});
+			_truncate(_size - (to - from));
+		}
+		return begin() + from;
+	}
+	
+	/**
+	 * @brief erase a row
+	 * @param toRemove iterator to the row to erase
+	 * @return iterator to the row that followed it
+	 */
+	iterator erase(const_iterator const &toRemove) { return erase(toRemove, toRemove + 1); }
+	
+	/**
+	 * @brief compare two vectors field by field
+	 * @param rhs right hand side
+	 * @return true if they hold equal rows
+	 */
+	bool operator==(const BasicVLSoA &rhs) const
+	{
+		if (_size != rhs._size)
+		{
+			return false;
+		}
+		bool equal = true;
+		_each([&](auto i) {
+			constexpr size_t I = decltype(i)::value;
+			equal = equal && std::equal(std::get<I>(_data), std::get<I>(_data) + _size, std::get<I>(rhs._data));
+		});
+		return equal;
+	}
+	
+	/**
+	 * @brief compare two vectors field by field
+	 * @param rhs right hand side
+	 * @return true if they differ
+	 */
+	bool operator!=(const BasicVLSoA &rhs) const { return !(*this == rhs); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's begin
+	 */
+	iterator begin() { return iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator begin() const { return const_iterator(this, 0); }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's end
+	 */
+	iterator end() { return iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator end() const { return const_iterator(this, _size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	const_iterator cbegin() const { return begin(); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's end
+	 */
+	const_iterator cend() const { return end(); }
+
+private:
+	/**
+	 * @brief copy the rows of other into our empty buffers, which must have room for them
+	 * @param other the vector to copy
+	 */
+	void _copy(BasicVLSoA const &other)
+	{
+		_fill(other._size, [&](auto i, auto *first) {
+			constexpr size_t I = decltype(i)::value;
+			std::uninitialized_copy_n(std::get<I>(other._data), other._size, first);
+		});
+	}
+};
+
+/**
+ * @brief exchange the content of two vectors, see BasicVLSoA::swap
+ * @param lhs left hand side
+ * @param rhs right hand side
+ */
+template<unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class... Fields>
+void swap(BasicVLSoA<StaticCapacity, GrowthPolicy, ShrinkPolicy, Fields...> &lhs,
+		  BasicVLSoA<StaticCapacity, GrowthPolicy, ShrinkPolicy, Fields...> &rhs) noexcept
+{
+	lhs.swap(rhs);
+}
+
+/**
+ * @brief structure-of-arrays vector with a chosen number of inline rows
+ */
+template<unsigned long StaticCapacity, class... Fields>
+using StaticVLSoA = BasicVLSoA<StaticCapacity, GrowOneAndHalf, ShrinkBelowWatermark<>, Fields...>;
+
+/**
+ * @brief structure-of-arrays vector with the default number of inline rows
+ */
+template<class... Fields>
+using VLSoA = BasicVLSoA<DEFAULT_STATIC_CAPACITY, GrowOneAndHalf, ShrinkBelowWatermark<>, Fields...>;
+
+#endif // VLSOA_HPP
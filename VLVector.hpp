@@ -6,27 +6,570 @@
  * @brief   Virtual Length Vector.
  */
 
+#ifndef VLVECTOR_HPP
+#define VLVECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "VLSearch.hpp"
 
 #define DEFAULT_STATIC_CAPACITY 16
 
-static size_t capfunc(size_t s, int stat, size_t nowCap);
+/**
+ * C++20 allocates in constant evaluation, so the core of VLVector is constexpr there - see VLVector::_constEval
+ */
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc) && \
+	defined(__cpp_lib_is_constant_evaluated)
+#define VL_HAS_CONSTEXPR 1
+#define VL_CONSTEXPR constexpr
+#else
+#define VL_HAS_CONSTEXPR 0
+#define VL_CONSTEXPR
+#endif
+
+/**
+ * @brief the default VLVector allocator - plain malloc/free, so a heap buffer can grow in place with realloc.
+ * over-aligned types fall back to the aligned operator new
+ * @tparam T the type of the elements
+ */
+template<class T>
+struct VLAllocator
+{
+	typedef T value_type;
+	
+	VLAllocator() noexcept = default;
+	
+	template<class U>
+	VLAllocator(const VLAllocator<U> &) noexcept {}
+	
+	/**
+	 * @brief the largest number of slots whose byte size fits a size_t
+	 * @return the largest n allocate accepts
+	 */
+	static constexpr size_t max_size() noexcept { return std::numeric_limits<size_t>::max() / sizeof(T); }
+	
+	/**
+	 * @brief allocate raw memory for n elements, no element is constructed
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	T *allocate(size_t n)
+	{
+		if (n > max_size()) // n * sizeof(T) would wrap around to a small block
+		{
+			throw std::bad_array_new_length();
+		}
+		if constexpr (alignof(T) > alignof(std::max_align_t))
+		{
+			return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+		}
+		else
+		{
+			void *p = std::malloc(n * sizeof(T));
+			if (p == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			return static_cast<T *>(p);
+		}
+	}
+	
+	/**
+	 * @brief release memory that was taken with allocate
+	 * @param p pointer to the first slot
+	 */
+	void deallocate(T *p, size_t) noexcept
+	{
+		if constexpr (alignof(T) > alignof(std::max_align_t))
+		{
+			::operator delete(p, std::align_val_t(alignof(T)));
+		}
+		else
+		{
+			std::free(p);
+		}
+	}
+	
+	/**
+	 * @brief resize a block that was taken with allocate, keeping its first min(oldN, n) elements' bytes.
+	 * only valid for trivially relocatable elements
+	 * @param p pointer to the first slot
+	 * @param oldN the current number of slots
+	 * @param n the new number of slots
+	 * @return pointer to the resized block, p itself if it grew in place
+	 */
+	T *reallocate(T *p, size_t oldN, size_t n)
+	{
+		if (n > max_size())
+		{
+			throw std::bad_array_new_length();
+		}
+		if constexpr (alignof(T) > alignof(std::max_align_t))
+		{
+			T *newP = allocate(n);
+			std::memcpy(static_cast<void *>(newP), static_cast<const void *>(p), std::min(oldN, n) * sizeof(T));
+			deallocate(p, oldN);
+			return newP;
+		}
+		else
+		{
+			void *newP = std::realloc(static_cast<void *>(p), n * sizeof(T));
+			if (newP == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			return static_cast<T *>(newP);
+		}
+	}
+};
+
+template<class T, class U>
+bool operator==(const VLAllocator<T> &, const VLAllocator<U> &) noexcept { return true; }
+
+template<class T, class U>
+bool operator!=(const VLAllocator<T> &, const VLAllocator<U> &) noexcept { return false; }
+
+/**
+ * @brief tells if an allocator can resize its blocks with a member reallocate(p, oldN, n), like VLAllocator
+ * @tparam A the allocator type
+ */
+template<class A, class = void>
+struct HasReallocate : std::false_type
+{
+};
+
+template<class A>
+struct HasReallocate<A, std::void_t<decltype(std::declval<A &>().reallocate(
+		std::declval<typename A::value_type *>(), size_t(), size_t()))>> : std::true_type
+{
+};
+
+/**
+ * growth policies - each one is a type with a static function
+ *     size_t grow(size_t s, size_t nowCap, size_t elemSize)
+ * that gets a size s that does not fit the current heap (or inline) capacity nowCap and returns the new heap
+ * capacity, which must be at least s. the result saturates instead of wrapping around, VLVector caps it at
+ * its max_size().
+ */
+
+/**
+ * @brief grow to 3/2 of the needed size - the classic VLVector behaviour
+ */
+struct GrowOneAndHalf
+{
+	static constexpr size_t grow(size_t s, size_t, size_t)
+	{
+		return s > std::numeric_limits<size_t>::max() - s / 2 ? std::numeric_limits<size_t>::max() : s + s / 2;
+	}
+};
+
+/**
+ * @brief double the current capacity, or more if the needed size is larger
+ */
+struct GrowDouble
+{
+	static constexpr size_t grow(size_t s, size_t nowCap, size_t)
+	{
+		return nowCap > std::numeric_limits<size_t>::max() / 2 ? std::numeric_limits<size_t>::max()
+															   : std::max(2 * nowCap, s);
+	}
+};
+
+/**
+ * @brief round the needed size up to the next power of two
+ */
+struct GrowPowerOfTwo
+{
+	static constexpr size_t grow(size_t s, size_t, size_t)
+	{
+		if (s > std::numeric_limits<size_t>::max() / 2 + 1) // no power of two above it, the shift would wrap to 0
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+		size_t cap = 1;
+		while (cap < s)
+		{
+			cap <<= 1;
+		}
+		return cap;
+	}
+};
+
+/**
+ * @brief grow to 3/2 of the needed size and round the buffer up to the malloc size class it would land in
+ * anyway (16 byte steps for small blocks, then four classes per power of two), so the slack is usable
+ */
+struct GrowMallocSizeClass
+{
+	static constexpr size_t grow(size_t s, size_t, size_t elemSize)
+	{
+		if (s > std::numeric_limits<size_t>::max() / 4 / elemSize) // too big for size classes to matter
+		{
+			return GrowOneAndHalf::grow(s, s, elemSize);
+		}
+		size_t bytes = ((3 * (s)) / 2) * elemSize;
+		size_t step = 16;
+		if (bytes > 128)
+		{
+			size_t pow = 1;
+			while (pow < bytes)
+			{
+				pow <<= 1;
+			}
+			step = pow / 8; // [pow / 2, pow] is split into four classes
+		}
+		bytes = (bytes + step - 1) / step * step;
+		return std::max(s, bytes / elemSize);
+	}
+};
+
+/**
+ * @brief tells if an object of type T may be moved to another address by copying its bytes and forgetting
+ * the source, without running the move constructor and the destructor. every trivially copyable type is,
+ * specialize to std::true_type for other types that only own their resources through plain pointers.
+ * @tparam T the type to check
+ */
+template<class T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+/**
+ * @brief std::unique_ptr is relocatable bytewise as long as its deleter is
+ */
+template<class T, class D>
+struct IsTriviallyRelocatable<std::unique_ptr<T, D>> : IsTriviallyRelocatable<D>
+{
+};
+
+/**
+ * @brief tells if two objects of type T are equal exactly when their bytes are, and order like their values,
+ * so vectors of T compare with memcmp. integers, enums and pointers are, specialize to std::true_type for
+ * structs without padding whose operator== and operator< compare all their fields in declaration order.
+ * @tparam T the type to check
+ */
+template<class T>
+struct IsBitwiseComparable : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value ||
+														 std::is_pointer<T>::value>
+{
+};
+
+/**
+ * shrink policies - each one is a type with
+ *     static constexpr bool onRequest - shrink_to_fit gives memory back
+ *     static bool shrink(size_t s, size_t cap) - a heap buffer of capacity cap that now holds s elements
+ *                                                is given back right away
+ */
+
+/**
+ * @brief keep the heap buffer until the vector dies, shrink_to_fit does nothing
+ */
+struct ShrinkNever
+{
+	static constexpr bool onRequest = false;
+	
+	static constexpr bool shrink(size_t, size_t) { return false; }
+};
+
+/**
+ * @brief give memory back only on an explicit shrink_to_fit
+ */
+struct ShrinkOnRequest
+{
+	static constexpr bool onRequest = true;
+	
+	static constexpr bool shrink(size_t, size_t) { return false; }
+};
+
+/**
+ * @brief give memory back once the size drops below Num/Den of the heap capacity (and on shrink_to_fit).
+ * the gap between the growth point and the watermark makes push/pop around a boundary amortized O(1)
+ * @tparam Num watermark numerator
+ * @tparam Den watermark denominator
+ */
+template<size_t Num = 1, size_t Den = 4>
+struct ShrinkBelowWatermark
+{
+	static constexpr bool onRequest = true;
+	
+	static constexpr bool shrink(size_t s, size_t cap) { return s * Den < cap * Num; }
+};
 
 /**
  * @brief needed date structure
  * @tparam T generic type
  * @tparam StaticCapacity
+ * @tparam GrowthPolicy decides the heap capacity when the vector outgrows its buffer (see GrowOneAndHalf)
+ * @tparam ShrinkPolicy decides when a heap buffer is given back (see ShrinkBelowWatermark)
+ * @tparam Allocator gives the heap buffers, the inline buffer never comes from it
  */
-template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY>
+template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+		class ShrinkPolicy = ShrinkBelowWatermark<>, class Allocator = VLAllocator<T>>
 class VLVector
 {
 private:
+	typedef std::allocator_traits<Allocator> _traits;
+	static_assert(std::is_same<typename _traits::pointer, T *>::value, "the allocator must hand out plain T*");
+	
+	[[no_unique_address]] Allocator _alloc;
+	T *_data; // the active buffer - stackArr, or the heap buffer once we spilled
 	size_t _size;
-	size_t _capacity;
-	T *heapArr;
-	T stackArr[StaticCapacity];
+	union
+	{
+		size_t _heapCap; // capacity of the heap buffer, in use iff _data is not stackArr
+		alignas(T) unsigned char stackArr[StaticCapacity * sizeof(T)]; // raw storage, only [0, _size) is alive
+	};
+	
+	VL_CONSTEXPR void _reCap(size_t newSize);
+	
+	VL_CONSTEXPR size_t _capFor(size_t s) const;
+	
+	/**
+	 * @brief checks if we run in constant evaluation. there the inline buffer cannot be used (its bytes are
+	 * not T objects), so the vector lives in a heap buffer from std::allocator from the start, and every
+	 * memcpy path is replaced by element by element moves
+	 * @return true at compile time
+	 */
+	static VL_CONSTEXPR bool _constEval() noexcept
+	{
+#if VL_HAS_CONSTEXPR
+		return std::is_constant_evaluated();
+#else
+		return false;
+#endif
+	}
+	
+	/**
+	 * @brief construct an element in an uninitialized slot, the way constant evaluation allows
+	 * @tparam Args types of the constructor arguments
+	 * @param p the slot
+	 * @param args the constructor arguments
+	 */
+	template<class... Args>
+	static VL_CONSTEXPR void _construct(T *p, Args &&... args)
+	{
+#if VL_HAS_CONSTEXPR
+		std::construct_at(p, std::forward<Args>(args)...);
+#else
+		new(p) T(std::forward<Args>(args)...);
+#endif
+	}
+	
+	/**
+	 * @brief copy a section into uninitialized slots, element by element in constant evaluation
+	 * @tparam InputIterator the type of the iterator over the section
+	 * @param first iterator to the first element
+	 * @param last iterator past the last element
+	 * @param to the first slot
+	 */
+	template<class InputIterator>
+	static VL_CONSTEXPR void _copyInto(InputIterator first, InputIterator last, T *to)
+	{
+		if (_constEval())
+		{
+			for (; first != last; ++first, ++to)
+			{
+				_construct(to, *first);
+			}
+			return;
+		}
+		std::uninitialized_copy(first, last, to);
+	}
+	
+	/**
+	 * @brief attach the empty vector to its first buffer - the inline one, or no buffer at all (a zero capacity
+	 * heap) in constant evaluation. a vector that was constant-initialized empty, a global say, keeps that state
+	 * at run time until it first grows
+	 */
+	VL_CONSTEXPR void _init() noexcept
+	{
+		if (_constEval())
+		{
+			_setHeap(nullptr, 0);
+		}
+		else
+		{
+			_heapCap = 0; // dead while inline, but gcc cannot always see that capacity() does not read it
+			_data = _stack();
+		}
+	}
+	
+	/**
+	 * @brief typed view of the inline storage
+	 * @return pointer to the first inline slot
+	 */
+	T *_stack() noexcept { return reinterpret_cast<T *>(stackArr); }
+	
+	/**
+	 * @brief typed read-only view of the inline storage
+	 * @return pointer to the first inline slot
+	 */
+	const T *_stack() const noexcept { return reinterpret_cast<const T *>(stackArr); }
+	
+	/**
+	 * @brief checks where the elements live
+	 * @return true if they are in a heap buffer, false if they are inline
+	 */
+	VL_CONSTEXPR bool _onHeap() const noexcept { return _constEval() || _data != _stack(); }
+	
+	/**
+	 * @brief switch to a heap buffer, the elements must be there already
+	 * @param arr the heap buffer
+	 * @param cap its capacity
+	 */
+	VL_CONSTEXPR void _setHeap(T *arr, size_t cap) noexcept
+	{
+		_data = arr;
+		_heapCap = cap;
+	}
+	
+	/**
+	 * elements are moved with memcpy/memmove instead of constructor and destructor calls
+	 */
+	static constexpr bool _bytewise = IsTriviallyRelocatable<T>::value;
+	
+	/**
+	 * the heap buffer can grow in place through the allocator's reallocate
+	 */
+	static constexpr bool _useRealloc = _bytewise && HasReallocate<Allocator>::value;
+	
+	/**
+	 * elements are compared with memcmp
+	 */
+	static constexpr bool _bitwiseCmp = IsBitwiseComparable<T>::value;
+	
+	/**
+	 * memcmp also orders the elements - single unsigned bytes
+	 */
+	static constexpr bool _memcmpOrder = _bitwiseCmp && sizeof(T) == 1 && !std::is_signed<T>::value &&
+										 !std::is_same<T, bool>::value;
+	
+	/**
+	 * @brief find the first position where two arrays of bitwise comparable elements differ, skipping equal
+	 * cache lines with memcmp
+	 * @param a the first array
+	 * @param b the second array
+	 * @param n the number of elements to look at
+	 * @return index of the first mismatch, n if there is none
+	 */
+	static size_t _mismatch(const T *a, const T *b, size_t n)
+	{
+		constexpr size_t block = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+		size_t i = 0;
+		while (i + block <= n && std::memcmp(a + i, b + i, block * sizeof(T)) == 0)
+		{
+			i += block;
+		}
+		while (i < n && a[i] == b[i])
+		{
+			i++;
+		}
+		return i;
+	}
+	
+	/**
+	 * @brief lexicographic order of two vectors
+	 * @param lhs left hand side vector
+	 * @param rhs right hand side vector
+	 * @return true if lhs comes before rhs
+	 */
+	static bool _less(const VLVector &lhs, const VLVector &rhs)
+	{
+		size_t common = std::min(lhs._size, rhs._size);
+		if constexpr (_memcmpOrder)
+		{
+			int cmp = common == 0 ? 0 : std::memcmp(lhs._data, rhs._data, common);
+			return cmp != 0 ? cmp < 0 : lhs._size < rhs._size;
+		}
+		else if constexpr (_bitwiseCmp)
+		{
+			size_t i = _mismatch(lhs._data, rhs._data, common);
+			return i < common ? lhs._data[i] < rhs._data[i] : lhs._size < rhs._size;
+		}
+		else
+		{
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+	}
+	
+	/**
+	 * @brief allocate raw heap memory for n elements, no element is constructed
+	 * @param n number of slots
+	 * @return pointer to the first slot
+	 */
+	VL_CONSTEXPR T *_allocate(size_t n)
+	{
+		if (_constEval())
+		{
+			return std::allocator<T>().allocate(n);
+		}
+		return _traits::allocate(_alloc, n);
+	}
+	
+	/**
+	 * @brief release raw heap memory that was taken with _allocate, the elements must be destroyed already.
+	 * the null buffer of a vector that never grew (see _init) is skipped
+	 * @param p pointer to the first slot
+	 * @param n number of slots
+	 */
+	VL_CONSTEXPR void _deallocate(T *p, size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		if (_constEval())
+		{
+			std::allocator<T>().deallocate(p, n);
+			return;
+		}
+		_traits::deallocate(_alloc, p, n);
+	}
 	
-	void _reCap(size_t preSize);
+	/**
+	 * @brief move (or copy, if moving may throw) n live elements into uninitialized memory and destroy the source
+	 * @param from first source element
+	 * @param n number of elements
+	 * @param to first destination slot
+	 */
+	static VL_CONSTEXPR void _relocate(T *from, size_t n, T *to)
+	{
+		if (_constEval())
+		{
+			for (size_t i = 0; i < n; i++)
+			{
+				_construct(to + i, std::move_if_noexcept(from[i]));
+			}
+		}
+		else if constexpr (_bytewise)
+		{
+			if (n != 0)
+			{
+				std::memcpy(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+			}
+			return;
+		}
+		else if constexpr (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value)
+		{
+			std::uninitialized_move(from, from + n, to);
+		}
+		else
+		{
+			std::uninitialized_copy(from, from + n, to);
+		}
+		std::destroy(from, from + n);
+	}
 
 public:
 	/**
@@ -41,21 +584,29 @@ public:
 	typedef const T *const_pointer;
 	typedef size_t difference_type;
 	typedef std::random_access_iterator_tag iterator_category;
+	typedef Allocator allocator_type;
 	
 	/**
-	 * @brief default constructor - creates a size 0 vector
+	 * @brief default constructor - creates a size 0 vector, no element is constructed
 	 */
-	VLVector() : _size(0), _capacity(StaticCapacity), heapArr(nullptr) {};
+	VL_CONSTEXPR VLVector() : _size(0) { _init(); };
 	
 	/**
-	 * @brief destructor - if the vector was longer than the static size,
+	 * @brief creates a size 0 vector whose heap buffers will come from the given allocator
+	 * @param alloc the allocator
+	 */
+	VL_CONSTEXPR explicit VLVector(const Allocator &alloc) : _alloc(alloc), _size(0) { _init(); };
+	
+	/**
+	 * @brief destructor - destroys the live elements and if the vector was longer than the static size,
 	 * we release the dynamic allocated memory
 	 */
-	~VLVector()
+	VL_CONSTEXPR ~VLVector()
 	{
-		if (_capacity > StaticCapacity)
+		std::destroy(begin(), end());
+		if (_onHeap())
 		{
-			delete[] (heapArr);
+			_deallocate(_data, _heapCap);
 		}
 	}
 	
@@ -64,21 +615,33 @@ public:
 	 * @tparam InputIterator the type of the iterator that holds the data to insert into a vector
 	 * @param first iterator to the first element in the section
 	 * @param last iterator to the last element in the section
+	 * @param alloc the allocator of the new vector
 	 */
 	template<class InputIterator>
-	VLVector(InputIterator const &first, InputIterator const &last): VLVector()
+	VL_CONSTEXPR VLVector(InputIterator const &first, InputIterator const &last, const Allocator &alloc = Allocator()):
+			VLVector(alloc)
 	{
-		for (auto in = first; in != last; in++)
-		{
-			push_back(*in);
-		}
+		assign(first, last);
 	}
 	
 	/**
-	 * @brief copy constractor
+	 * @brief copy constractor - allocates once and copy-constructs the elements
 	 * @param other the vector to be copied into a new vector
 	 */
-	VLVector(VLVector const &other) : VLVector(other.begin(), other.end()) {};
+	VL_CONSTEXPR VLVector(VLVector const &other) :
+			VLVector(other.begin(), other.end(), _traits::select_on_container_copy_construction(other._alloc)) {};
+	
+	/**
+	 * @brief move constractor - steals the heap buffer in O(1) together with the allocator,
+	 * inline elements are moved one by one. other is left empty
+	 * @param other the vector to be moved into a new vector
+	 */
+	VL_CONSTEXPR VLVector(VLVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) :
+			_alloc(std::move(other._alloc)), _size(0)
+	{
+		_init();
+		_steal(other);
+	}
 	
 	/**
 	 * @brief define operator '=' for vector assignment
@@ -87,208 +650,542 @@ public:
 	 */
 	VLVector &operator=(VLVector const &rhs)
 	{
-		if (&rhs == *this)
+		if (&rhs == this)
 		{
 			return *this;
 		}
-		this->clear();
-		*this = VLVector(rhs);
+		if constexpr (_traits::propagate_on_container_copy_assignment::value)
+		{
+			if (!(_alloc == rhs._alloc)) // our buffer goes back to the allocator that gave it
+			{
+				_release();
+			}
+			_alloc = rhs._alloc;
+		}
+		assign(rhs.begin(), rhs.end());
 		return *this;
 	}
 	
+	/**
+	 * @brief define operator '=' for vector move assignment, rhs is left empty. the heap buffer of rhs is
+	 * taken over only if its allocator can free it here, otherwise the elements are moved one by one
+	 * @param rhs right hand side
+	 * @return reference to the result vector
+	 */
+	VLVector &operator=(VLVector &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value &&
+												 (_traits::propagate_on_container_move_assignment::value ||
+												  _traits::is_always_equal::value))
+	{
+		if (&rhs == this)
+		{
+			return *this;
+		}
+		if (_traits::propagate_on_container_move_assignment::value || _alloc == rhs._alloc)
+		{
+			_release();
+			if constexpr (_traits::propagate_on_container_move_assignment::value)
+			{
+				_alloc = std::move(rhs._alloc);
+			}
+			_steal(rhs);
+		}
+		else
+		{
+			assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+			rhs.clear();
+		}
+		return *this;
+	}
+	
+	/**
+	 * @brief exchange the content of two vectors. heap buffers change hands in O(1) when the allocators allow it
+	 * (they propagate on swap or are equal), otherwise the elements are moved
+	 * @param other the vector to swap with
+	 */
+	void swap(VLVector &other)
+	{
+		if (&other == this)
+		{
+			return;
+		}
+		if (!_traits::propagate_on_container_swap::value && !(_alloc == other._alloc))
+		{
+			VLVector temp(std::move(*this));
+			*this = std::move(other);
+			other = std::move(temp);
+			return;
+		}
+		VLVector temp(std::move(*this));
+		if constexpr (_traits::propagate_on_container_swap::value)
+		{
+			_alloc = other._alloc;
+			other._alloc = temp._alloc;
+		}
+		_steal(other);
+		other._steal(temp);
+	}
+	
+	/**
+	 * @brief getter for the allocator
+	 * @return a copy of the allocator
+	 */
+	Allocator get_allocator() const { return _alloc; }
+	
+	/**
+	 * @brief replace the content with a section of an iterative data structure. when the section size is known
+	 * in advance (forward iterators) and does not fit, exactly that many slots are allocated. a bigger buffer is
+	 * kept
+	 * @tparam InputIterator the type of the iterator that holds the data to put in the vector
+	 * @param first iterator to the first element in the section
+	 * @param last iterator to the element after the section
+	 */
+	template<class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+	VL_CONSTEXPR void assign(InputIterator first, InputIterator last)
+	{
+		std::destroy(begin(), end());
+		_size = 0;
+		if constexpr (std::is_base_of<std::forward_iterator_tag,
+				typename std::iterator_traits<InputIterator>::iterator_category>::value)
+		{
+			size_t numAdd = std::distance(first, last);
+			reserve(numAdd);
+			_copyInto(first, last, begin());
+			_size = numAdd;
+		}
+		else
+		{
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+		}
+	}
+	
+	/**
+	 * @brief replace the content with count copies of a value, allocating exactly count slots if needed. a bigger
+	 * buffer is kept
+	 * @param count the new size
+	 * @param val the value to copy
+	 */
+	void assign(size_t count, const T &val)
+	{
+		if (count > capacity()) // val may be one of ours, copy it before the old elements go
+		{
+			T toAdd(val);
+			std::destroy(begin(), end());
+			_size = 0;
+			reserve(count);
+			std::uninitialized_fill_n(begin(), count, toAdd);
+		}
+		else
+		{
+			std::fill_n(begin(), std::min(count, _size), val);
+			if (count > _size)
+			{
+				std::uninitialized_fill_n(end(), count - _size, val);
+			}
+			else
+			{
+				std::destroy(begin() + count, end());
+			}
+		}
+		_size = count;
+	}
+	
 	/**
 	 * @brief getter for size attribute
 	 * @return size
 	 */
-	size_t size() const { return _size; }
+	VL_CONSTEXPR size_t size() const { return _size; }
 	
 	/**
 	 * @brief append the new element to the end of the vector
 	 * @param add element to add
 	 */
-	void push_back(const T &add)
+	VL_CONSTEXPR void push_back(const T &add) { emplace_back(add); }
+	
+	/**
+	 * @brief append the new element to the end of the vector by moving it
+	 * @param add element to add
+	 */
+	VL_CONSTEXPR void push_back(T &&add) { emplace_back(std::move(add)); }
+	
+	/**
+	 * @brief construct a new element in place at the end of the vector
+	 * @tparam Args types of the constructor arguments
+	 * @param args the constructor arguments of the new element
+	 * @return reference to the new element
+	 */
+	template<class... Args>
+	VL_CONSTEXPR T &emplace_back(Args &&... args)
 	{
-		_size++;
-		_reCap(_size - 1);
-		if (_capacity > StaticCapacity)
+		if (_size + 1 > capacity() && _useRealloc) // realloc may release our elements, build the new one aside
+		{
+			T toAdd(std::forward<Args>(args)...);
+			_reallocWithGap(_capFor(_size + 1), _size, 1, [&](T *gap)
+			{
+				_construct(gap, std::move(toAdd));
+			});
+		}
+		else if (_size + 1 > capacity()) // the new element is built in the new buffer first, args may refer to our elements
 		{
-			heapArr[_size - 1] = add;
+			_reallocWithGap(_capFor(_size + 1), _size, 1, [&](T *gap)
+			{
+				_construct(gap, std::forward<Args>(args)...);
+			});
 		}
 		else
 		{
-			stackArr[_size - 1] = add;
+			_construct(end(), std::forward<Args>(args)...);
 		}
+		_size++;
+		return *(end() - 1);
 	}
 	
 	/**
 	 * @brief getter for capacity attribute
 	 * @return capacity
 	 */
-	size_t capacity() const { return _capacity; }
+	VL_CONSTEXPR size_t capacity() const { return _onHeap() ? _heapCap : StaticCapacity; }
+	
+	/**
+	 * @brief the largest size the allocator can hand out a buffer for
+	 * @return max size
+	 */
+	VL_CONSTEXPR size_t max_size() const noexcept { return _traits::max_size(_alloc); }
 	
 	/**
 	 * @brief checks if the vector is empty
 	 * @return if empty - true, otherwise - false
 	 */
-	bool empty() const { return _size == 0; }
+	VL_CONSTEXPR bool empty() const { return _size == 0; }
 	
 	/**
 	 * @brief remove the last element in the vector if exists
 	 */
-	void pop_back()
+	VL_CONSTEXPR void pop_back()
 	{
 		if (_size == 0)
 		{
 			return;
 		}
 		_size--;
-		_reCap(_size + 1);
+		std::destroy_at(end());
+		_reCap(_size);
 	}
 	
 	/**
-	 * @brief empty the vector, release allocated memory if needed
+	 * @brief empty the vector, release allocated memory if the shrink policy says so
 	 */
-	void clear()
+	VL_CONSTEXPR void clear()
 	{
 		if (_size == 0)
 		{
 			return;
 		}
-		size_t preSize = _size;
+		std::destroy(begin(), end());
 		_size = 0;
-		_reCap(preSize);
+		_reCap(_size);
 	}
 	
 	/**
-	 * @brief Gives read-only access to information contained in Vector
-	 * @return returns a pointer to the data type that holds the information within the vector
+	 * @brief make room for at least n elements with a single allocation of exactly n slots, if they do not fit
+	 * the current buffer. never shrinks
+	 * @param n the number of elements the caller is about to hold
 	 */
-	const T *data() const noexcept
+	VL_CONSTEXPR void reserve(size_t n)
 	{
-		if (_capacity > StaticCapacity)
+		if (n > max_size())
 		{
-			return heapArr;
+			throw std::length_error("VLVector too long");
+		}
+		if (n > capacity())
+		{
+			_reallocWithGap(n, _size, 0, [](T *) {});
+		}
+	}
+	
+	/**
+	 * @brief change the size - new elements are value-initialized, removed ones are destroyed.
+	 * growth beyond the capacity goes through the growth policy, like push_back
+	 * @param count the new size
+	 */
+	void resize(size_t count)
+	{
+		if (count > _size)
+		{
+			_growFor(count);
+			std::uninitialized_value_construct(end(), begin() + count);
+			_size = count;
+		}
+		else
+		{
+			_truncate(count);
+		}
+	}
+	
+	/**
+	 * @brief change the size - new elements are copies of val, removed ones are destroyed.
+	 * growth beyond the capacity goes through the growth policy, like push_back
+	 * @param count the new size
+	 * @param val the value to copy into the new elements
+	 */
+	void resize(size_t count, const T &val)
+	{
+		if (count > _size)
+		{
+			T toAdd(val); // val may be one of ours
+			_growFor(count);
+			std::uninitialized_fill(end(), begin() + count, toAdd);
+			_size = count;
 		}
 		else
 		{
-			return stackArr;
+			_truncate(count);
 		}
 	}
 	
+	/**
+	 * @brief append n elements without writing them, their bytes are whatever the caller copies in next (a memcpy,
+	 * a read). only for trivially copyable elements. growth beyond the capacity goes through the growth policy,
+	 * like push_back
+	 * @param n the number of elements to append
+	 * @return pointer to the first new element
+	 */
+	T *append_uninitialized(size_t n)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements may be left unwritten");
+		if (n > max_size() - _size)
+		{
+			throw std::length_error("VLVector too long");
+		}
+		_growFor(_size + n);
+		T *added = end();
+		_size += n;
+		return added;
+	}
+	
+	/**
+	 * @brief give back the unused capacity - the elements go back to the stack if they fit there, otherwise
+	 * to a heap buffer of exactly size() slots. does nothing if the shrink policy ignores requests
+	 */
+	void shrink_to_fit()
+	{
+		if (!ShrinkPolicy::onRequest || !_onHeap() || _heapCap == _size)
+		{
+			return;
+		}
+		_shrinkTo(std::max(_size, (size_t) StaticCapacity));
+	}
+	
+	/**
+	 * @brief Gives read-only access to information contained in Vector
+	 * @return returns a pointer to the data type that holds the information within the vector
+	 */
+	VL_CONSTEXPR const T *data() const noexcept { return _data; }
+	
 	/**
 	 * @brief Gives full access to information contained in Vector
 	 * @return returns a pointer to the data type that holds the information within the vector
 	 */
-	T *data() noexcept
+	VL_CONSTEXPR T *data() noexcept { return _data; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return value in given access
+	 */
+	VL_CONSTEXPR T &operator[](const size_t &idx) { return _data[idx]; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	VL_CONSTEXPR const T &operator[](const size_t &idx) const { return _data[idx]; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	VL_CONSTEXPR const T &at(const size_t idx) const
 	{
-		if (_capacity > StaticCapacity)
+		if (idx < _size)
 		{
-			return heapArr;
+			return (*this)[idx];
 		}
 		else
 		{
-			return stackArr;
+			throw std::out_of_range("index out of range");
 		}
 	}
 	
 	/**
-	 * @brief access the requested index and returns the value found in it
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the vector range
 	 * @param idx index to access
 	 * @return value in given access
 	 */
-	T &operator[](const size_t &idx)
+	VL_CONSTEXPR T &at(const size_t idx)  //
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief Define a comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if equal - true otherwise - false
+	 */
+	bool operator==(const VLVector &rhs) const
+	{
+		if (_size != rhs._size)
+		{
+			return false;
+		}
+		if constexpr (_bitwiseCmp)
+		{
+			return _size == 0 || std::memcmp(_data, rhs._data, _size * sizeof(T)) == 0;
+		}
+		else
+		{
+			return std::equal(begin(), end(), rhs.begin());
+		}
+	}
+	
+	/**
+	 * @brief use the comparison between vectors function to assess if the
+	 * vectors are not equal
+	 * @param rhs right hand size vector to compere to
+	 * @return if not equal - true otherwise - false
+	 */
+	bool operator!=(const VLVector &rhs) const { return !(*this == rhs); }
+	
+	/**
+	 * @brief lexicographic comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if this vector comes first - true otherwise - false
+	 */
+	bool operator<(const VLVector &rhs) const { return _less(*this, rhs); }
+	
+	/**
+	 * @brief lexicographic comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if rhs comes first - true otherwise - false
+	 */
+	bool operator>(const VLVector &rhs) const { return _less(rhs, *this); }
+	
+	/**
+	 * @brief lexicographic comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if rhs does not come first - true otherwise - false
+	 */
+	bool operator<=(const VLVector &rhs) const { return !_less(rhs, *this); }
+	
+	/**
+	 * @brief lexicographic comparison between vectors
+	 * @param rhs right hand size vector to compere to
+	 * @return if this vector does not come first - true otherwise - false
+	 */
+	bool operator>=(const VLVector &rhs) const { return !_less(*this, rhs); }
+	
+	/**
+	 * @brief search for the first element equal to val. integral elements are searched with SIMD, a vector
+	 * that fits one register is searched with a single load
+	 * @param val the value to look for
+	 * @return iterator to the element, end() if there is none
+	 */
+	const_iterator find(const T &val) const
 	{
-		if (_capacity > StaticCapacity)
+		if constexpr (VLSearch<T>::simd)
 		{
-			return heapArr[idx];
+			return _data + VLSearch<T>::find(_data, _size, capacity(), &val, 1);
 		}
 		else
 		{
-			return stackArr[idx];
+			return std::find(begin(), end(), val);
 		}
 	}
 	
 	/**
-	 * @brief access the requested index and returns the value found in it
-	 * @param idx index to access
-	 * @return read-only value in given access
+	 * @brief search for the first element equal to val
+	 * @param val the value to look for
+	 * @return iterator to the element, end() if there is none
 	 */
-	const T &operator[](const size_t &idx) const
-	{
-		if (_capacity > StaticCapacity)
-		{
-			return heapArr[idx];
-		}
-		else
-		{
-			return stackArr[idx];
-		}
-	}
+	iterator find(const T &val) { return begin() + (std::as_const(*this).find(val) - cbegin()); }
 	
 	/**
-	 * @brief access the requested index and returns the value found in it,
-	 * while verifying that the index is in the vector range
-	 * @param idx index to access
-	 * @return read-only value in given access
+	 * @brief count the elements equal to val
+	 * @param val the value to look for
+	 * @return the count
 	 */
-	const T &at(const size_t idx) const
+	size_t count(const T &val) const
 	{
-		if (idx < _size)
+		if constexpr (VLSearch<T>::simd)
 		{
-			return (*this)[idx];
+			return VLSearch<T>::count(_data, _size, capacity(), val);
 		}
 		else
 		{
-			throw std::out_of_range("index out of range");
+			return std::count(begin(), end(), val);
 		}
 	}
 	
 	/**
-	 * @brief access the requested index and returns the value found in it,
-	 * while verifying that the index is in the vector range
-	 * @param idx index to access
-	 * @return value in given access
+	 * @brief checks if an element equals val
+	 * @param val the value to look for
+	 * @return if found - true, otherwise - false
 	 */
-	T &at(const size_t idx)  //
-	{
-		if (idx < _size)
-		{
-			return (*this)[idx];
-		}
-		else
-		{
-			throw std::out_of_range("index out of range");
-		}
-	}
+	bool contains(const T &val) const { return find(val) != end(); }
 	
 	/**
-	 * @brief Define a comparison between vectors
-	 * @param rhs right hand size vector to compere to
-	 * @return if equal - true otherwise - false
+	 * @brief search for the first element equal to any of a section of values. integral elements are searched
+	 * with SIMD when there are at most VL_SEARCH_MAX_NEEDLES values
+	 * @tparam ForwardIterator the type of the iterator that holds the values
+	 * @param first iterator to the first value
+	 * @param last iterator to the last value (not included)
+	 * @return iterator to the element, end() if there is none
 	 */
-	bool operator==(const VLVector &rhs) const
+	template<class ForwardIterator>
+	const_iterator find_first_of(ForwardIterator first, ForwardIterator last) const
 	{
-		if (_size != rhs._size)
-		{
-			return false;
-		}
-		for (size_t i = 0; i < _size; i++)
+		if constexpr (VLSearch<T>::simd)
 		{
-			if ((*this)[i] != rhs[i])
+			T needles[VL_SEARCH_MAX_NEEDLES];
+			size_t m = 0;
+			ForwardIterator it = first;
+			for (; it != last && m < VL_SEARCH_MAX_NEEDLES; ++it)
+			{
+				needles[m++] = *it;
+			}
+			if (it == last)
 			{
-				return false;
+				return m == 0 ? end() : _data + VLSearch<T>::find(_data, _size, capacity(), needles, m);
 			}
 		}
-		return true;
+		return std::find_first_of(begin(), end(), first, last);
 	}
 	
 	/**
-	 * @brief use the comparison between vectors function to assess if the
-	 * vectors are not equal
-	 * @param rhs right hand size vector to compere to
-	 * @return if not equal - true otherwise - false
+	 * @brief search for the first element equal to any of a section of values
+	 * @tparam ForwardIterator the type of the iterator that holds the values
+	 * @param first iterator to the first value
+	 * @param last iterator to the last value (not included)
+	 * @return iterator to the element, end() if there is none
 	 */
-	bool operator!=(const VLVector &rhs) const { return !(*this == rhs); }
+	template<class ForwardIterator>
+	iterator find_first_of(ForwardIterator first, ForwardIterator last)
+	{
+		return begin() + (std::as_const(*this).find_first_of(first, last) - cbegin());
+	}
 	
 	/**
 	 * @brief Insert a section of elements into a specified location
@@ -300,88 +1197,88 @@ public:
 	 * @return iterator to the first element we insert
 	 */
 	template<class InputIterator>
-	iterator insert(iterator const &position, InputIterator const &first, InputIterator const &last)
+	VL_CONSTEXPR iterator insert(iterator const &position, InputIterator const &first, InputIterator const &last)
 	{
-		auto temp = VLVector(first, last); // we put the values in VLVector and now we have random access.
+		VLVector temp(first, last, _alloc); // we put the values in VLVector and now we have random access.
 		size_t numAdd = temp._size;
 		size_t disPos = position - begin();
-		if (_capacity > StaticCapacity) // we are on the heap
+		if (numAdd == 0) // nothing to insert, shifting by zero would move the tail onto itself
 		{
-			size_t orgSize = _size;
-			_capacity = capfunc(_size + numAdd, StaticCapacity, _capacity);
-			_size += numAdd;
-			T *newArr = new T[_capacity];
-			std::copy(begin(), position, newArr);
-			std::copy(temp.begin(), temp.end(), newArr + disPos);
-			std::copy(position, begin() + orgSize, newArr + disPos + numAdd);
-			delete[](heapArr);
-			heapArr = newArr;
+			return begin() + disPos;
 		}
-		else if (_size + numAdd > StaticCapacity) // stack to heap
+		if (_size + numAdd > capacity()) // no room, we move to a bigger heap buffer
 		{
-			size_t orgSize = _size;
-			_capacity = capfunc(_size + numAdd, StaticCapacity, _capacity);
+			_reallocWithGap(_capFor(_size + numAdd), disPos, numAdd, [&](T *gap)
+			{
+				_copyInto(std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()), gap);
+			});
 			_size += numAdd;
-			T *newArr = new T[_capacity];
-			std::copy(stackArr, position, newArr);
-			std::copy(temp.begin(), temp.end(), newArr + disPos);
-			std::copy(position, stackArr + orgSize, newArr + disPos + numAdd);
-			heapArr = newArr;
 		}
-		else // we stay on the stack
+		else // we stay where we are, shift the tail right starting from the last element
 		{
-			T newArr[StaticCapacity];
-			size_t orgSize = _size;
-			_size += numAdd;
-			std::copy(begin(), begin() + orgSize, newArr);
-			std::copy(temp.begin(), temp.end(), stackArr + disPos);
-			std::copy(newArr + disPos, newArr + orgSize, (stackArr + disPos) + numAdd);
+			_insertInPlace(disPos, numAdd, [&](size_t i) -> T && { return std::move(temp[i]); });
 		}
 		temp.clear();
-		return begin() + numAdd;
+		return begin() + disPos;
 	}
 	
 	/**
 	 * @brief insert a singel data unit to the vector in a specified location
 	 * @param position the specified location.
 	 * @param toAdd the data unit, have to be in type T
-	 * @return
+	 * @return iterator to the inserted element
+	 */
+	VL_CONSTEXPR iterator insert(const_iterator const &position, const T &toAdd) { return emplace(position, toAdd); }
+	
+	/**
+	 * @brief insert a singel data unit to the vector in a specified location by moving it
+	 * @param position the specified location.
+	 * @param toAdd the data unit, have to be in type T
+	 * @return iterator to the inserted element
+	 */
+	VL_CONSTEXPR iterator insert(const_iterator const &position, T &&toAdd)
+	{
+		return emplace(position, std::move(toAdd));
+	}
+	
+	/**
+	 * @brief construct a new element in place at a specified location
+	 * @tparam Args types of the constructor arguments
+	 * @param position the specified location.
+	 * @param args the constructor arguments of the new element
+	 * @return iterator to the new element
 	 */
-	iterator insert(iterator const &position, T toAdd)
+	template<class... Args>
+	VL_CONSTEXPR iterator emplace(const_iterator const &position, Args &&... args)
 	{
 		size_t numAdd = 1;
 		size_t disPos = position - begin();
-		if (_capacity > StaticCapacity) // we are on the heap
+		if (_size + numAdd > capacity() && _useRealloc) // realloc may release our elements, build the new one aside
 		{
-			size_t orgSize = _size;
-			_capacity = capfunc(_size + numAdd, StaticCapacity, _capacity);
+			T toAdd(std::forward<Args>(args)...);
+			_reallocWithGap(_capFor(_size + numAdd), disPos, numAdd, [&](T *gap)
+			{
+				_construct(gap, std::move(toAdd));
+			});
 			_size += numAdd;
-			T *newArr = new T[_capacity];
-			std::copy(begin(), position, newArr);
-			newArr[disPos] = toAdd;
-			std::copy(position, begin() + orgSize, newArr + disPos + numAdd);
-			delete[](heapArr);
-			heapArr = newArr;
 		}
-		else if (_size + numAdd > StaticCapacity) // stack to heap
+		else if (_size + numAdd > capacity()) // no room, we move to a bigger heap buffer
 		{
-			size_t orgSize = _size;
-			_capacity = capfunc(_size + numAdd, StaticCapacity, _capacity);
+			_reallocWithGap(_capFor(_size + numAdd), disPos, numAdd, [&](T *gap)
+			{
+				_construct(gap, std::forward<Args>(args)...);
+			});
 			_size += numAdd;
-			T *newArr = new T[_capacity];
-			std::copy(stackArr, position, newArr);
-			newArr[disPos] = toAdd;
-			std::copy(position, stackArr + orgSize, newArr + disPos + numAdd);
-			heapArr = newArr;
 		}
-		else // we stay on the stack
+		else if (disPos == _size) // appending, nothing to shift
 		{
-			T newArr[StaticCapacity];
-			size_t orgSize = _size;
+			_construct(end(), std::forward<Args>(args)...);
 			_size += numAdd;
-			std::copy(begin(), begin() + orgSize, newArr);
-			stackArr[disPos] = toAdd;
-			std::copy(newArr + disPos, newArr + orgSize, (stackArr + disPos) + numAdd);
+		}
+		else // we stay where we are, shift the tail right starting from the last element
+		{
+			T toAdd(std::forward<Args>(args)...); // built before the shift, args may refer to our elements
+			_insertInPlace(disPos, numAdd, [&](size_t) -> T && { return std::move(toAdd); });
 		}
 		return begin() + disPos;
 	}
@@ -392,30 +1289,45 @@ public:
 	 * @param lastIterator for the item after the last item in the section
 	 * @return iterator to the item to the right of the section
 	 */
-	iterator erase(iterator const &first, iterator const &last)
+	VL_CONSTEXPR iterator erase(iterator const &first, iterator const &last)
 	{
 		size_t numSub = last - first;
 		size_t disFirst = first - begin();
-		if (_size <= StaticCapacity) // we stay on the stack
+		if (numSub == 0) // nothing to erase, and moving the tail onto itself would blank it
 		{
-			size_t orgSize = _size;
+			return begin() + disFirst;
+		}
+		if (!_constEval() && _onHeap() && (_size - numSub) <= StaticCapacity &&
+			ShrinkPolicy::shrink(_size - numSub, _heapCap)) //  heap to stack
+		{
+			T *oldArr = _data;
+			size_t oldCap = _heapCap; // read it before the elements overwrite it
+			size_t numTail = _size - (disFirst + numSub);
+			_relocate(oldArr, disFirst, _stack());
+			std::destroy(first, last);
+			_relocate(last, numTail, _stack() + disFirst);
+			_data = _stack();
 			_size -= numSub;
-			std::copy(last, begin() + orgSize, first); // shift to the left and override the section we deleting
+			_deallocate(oldArr, oldCap);
 		}
-		else if (_size > StaticCapacity && (_size - numSub) <= StaticCapacity) //  heap to stack
+		else if (_bytewise && !_constEval()) // we stay where we are, slide the tail bytes over the section we deleting
 		{
-			std::copy(heapArr, first, stackArr);
-			std::copy(last, end(), stackArr + disFirst);
-			_capacity = StaticCapacity;
+			size_t numTail = _size - (disFirst + numSub);
+			std::destroy(first, last);
+			if (numTail != 0)
+			{
+				std::memmove(static_cast<void *>(first), static_cast<const void *>(last), numTail * sizeof(T));
+			}
 			_size -= numSub;
-			delete[](heapArr);
-			heapArr = nullptr;
 		}
-		else // we stay on the heap
+		else // we stay where we are
 		{
-			std::copy(last, end(), heapArr + disFirst);
+			size_t orgSize = _size;
 			_size -= numSub;
+			std::move(last, begin() + orgSize, first); // shift to the left and override the section we deleting
+			std::destroy(begin() + _size, begin() + orgSize);
 		}
+		_reCap(_size);
 		return begin() + disFirst;
 	}
 	
@@ -424,117 +1336,490 @@ public:
 	 * @param toRemove iterator to the item we want to erase
 	 * @return iterator to the item to the right of the item we delete
 	 */
-	iterator erase(iterator const &toRemove)
+	VL_CONSTEXPR iterator erase(iterator const &toRemove)
 	{
 		iterator end = toRemove + 1;
 		return erase(toRemove, end);
 	}
 	
 	/**
-	 * @brief
-	 * @return iterator to the vector's begin
+	 * @brief erase an item in O(1) by putting the last item in its place, the order of the items changes
+	 * @param toRemove iterator to the item we want to erase
+	 * @return iterator to the item that took its place, end() if it was the last one
 	 */
-	iterator begin()
+	iterator erase_unordered(iterator const &toRemove)
 	{
-		if (this->_capacity > StaticCapacity)
+		size_t disPos = toRemove - begin();
+		T *last = _data + _size - 1;
+		if (toRemove != last && _bytewise) // the last item's bytes go over the erased one
 		{
-			return heapArr;
+			std::destroy_at(toRemove);
+			std::memcpy(static_cast<void *>(toRemove), static_cast<const void *>(last), sizeof(T));
+			_size--;
+			_reCap(_size);
 		}
 		else
 		{
-			return stackArr;
+			if (toRemove != last)
+			{
+				*toRemove = std::move(*last);
+			}
+			pop_back();
 		}
+		return begin() + disPos;
 	}
 	
 	/**
-	 * @brief
-	 * @return iterator to the vector's end
-	 */
-	iterator end() { return (begin() + this->_size); }
-	
-	/**
-	 * @brief
-	 * @return const iterator to the vector's begin
+	 * @brief erase every item that satisfies pred in a single pass - the kept items slide left over the erased
+	 * ones in order, and the buffer is reconsidered once at the end, so there is at most one heap to stack move
+	 * @tparam Predicate the type of the predicate
+	 * @param pred called as pred(item), true for the items to erase
+	 * @return the number of erased items
 	 */
-	const_iterator begin() const
+	template<class Predicate>
+	size_t erase_if(Predicate pred)
 	{
-		if (this->_capacity > StaticCapacity)
+		size_t orgSize = _size;
+		size_t kept = 0;
+		if constexpr (_bytewise) // erased items die on the spot, kept ones slide over as bytes
 		{
-			return heapArr;
+			size_t i = 0;
+			try
+			{
+				for (; i < orgSize; i++)
+				{
+					if (pred(_data[i]))
+					{
+						std::destroy_at(_data + i);
+					}
+					else
+					{
+						if (kept != i)
+						{
+							std::memcpy(static_cast<void *>(_data + kept), static_cast<const void *>(_data + i),
+										sizeof(T));
+						}
+						kept++;
+					}
+				}
+			}
+			catch (...) // close the gap so the unvisited items stay alive
+			{
+				std::memmove(static_cast<void *>(_data + kept), static_cast<const void *>(_data + i),
+							 (orgSize - i) * sizeof(T));
+				_size = kept + (orgSize - i);
+				throw;
+			}
+			_size = kept;
+			_reCap(_size);
 		}
 		else
 		{
-			return stackArr;
+			for (size_t i = 0; i < orgSize; i++)
+			{
+				if (!pred(_data[i]))
+				{
+					if (kept != i)
+					{
+						_data[kept] = std::move(_data[i]);
+					}
+					kept++;
+				}
+			}
+			_truncate(kept);
 		}
+		return orgSize - kept;
 	}
 	
+	/**
+	 * @brief
+	 * @return iterator to the vector's begin
+	 */
+	VL_CONSTEXPR iterator begin() { return _data; }
+	
+	/**
+	 * @brief
+	 * @return iterator to the vector's end
+	 */
+	VL_CONSTEXPR iterator end() { return (begin() + this->_size); }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the vector's begin
+	 */
+	VL_CONSTEXPR const_iterator begin() const { return _data; }
+	
 	/**
 	 * @brief
 	 * @return const iterator to the vector's end
 	 */
-	const_iterator end() const { return (begin() + this->_size); }
+	VL_CONSTEXPR const_iterator end() const { return (begin() + this->_size); }
 	
 	/**
 	 * @brief
 	 * @return const iterator to the vector's begin
 	 */
-	const_iterator cbegin() const { return begin(); }
+	VL_CONSTEXPR const_iterator cbegin() const { return begin(); }
 	
 	/**
 	 * @brief
 	 * @return const iterator to the vector's end
 	 */
-	const_iterator cend() const { return end(); }
-};
+	VL_CONSTEXPR const_iterator cend() const { return end(); }
 
-/**
- * @brief private function that change the memory location and size if we need to.
- * allocate or delete the heap memory.
- * @tparam T the type of the vector elements
- * @tparam StaticCapacity
- */
-template<typename T, unsigned long StaticCapacity>
-void VLVector<T, StaticCapacity>::_reCap(size_t prevSize) // we know the new size we update the capacity
-{
-	if (_size <= _capacity && _size > StaticCapacity) // no need to do anything
+private:
+	/**
+	 * @brief move the live elements into a new heap buffer around a gap of numAdd slots at disPos,
+	 * and release the old storage. the gap is filled before anything moves, so the new elements may be
+	 * built from the old ones - except when a heap buffer of a realloc-able type is grown in place, there
+	 * fill runs after the old buffer is gone
+	 * @tparam Fill callable that constructs numAdd elements at the pointer it gets
+	 * @param newCap capacity of the new heap buffer
+	 * @param disPos index of the first slot of the gap
+	 * @param numAdd size of the gap
+	 * @param fill constructs the gap elements
+	 */
+	template<class Fill>
+	VL_CONSTEXPR void _reallocWithGap(size_t newCap, size_t disPos, size_t numAdd, Fill &&fill)
+	{
+		if (_data == nullptr && !_constEval()) // constant-initialized empty, take our inline buffer first
+		{
+			_data = _stack();
+			if (newCap <= StaticCapacity)
+			{
+				fill(_data); // empty, so the gap is at 0
+				return;
+			}
+		}
+		if constexpr (_useRealloc)
+		{
+			if (_onHeap() && !_constEval()) // resize the heap block, the allocator may do it without a copy
+			{
+				_setHeap(_alloc.reallocate(_data, _heapCap, newCap), newCap);
+				_memmoveTail(disPos, disPos + numAdd);
+				try
+				{
+					fill(_data + disPos);
+				}
+				catch (...)
+				{
+					_memmoveTail(disPos + numAdd, disPos);
+					throw;
+				}
+				return;
+			}
+		}
+		T *newArr = _allocate(newCap);
+		try
+		{
+			fill(newArr + disPos);
+		}
+		catch (...)
+		{
+			_deallocate(newArr, newCap);
+			throw;
+		}
+		try
+		{
+			if (_onHeap())
+			{
+				_heapToHeap(newArr, newCap, disPos, numAdd);
+			}
+			else
+			{
+				_relocateAround(_stack(), newArr, disPos, numAdd);
+				_setHeap(newArr, newCap);
+			}
+		}
+		catch (...) // a copy threw, the old elements are all still there
+		{
+			std::destroy(newArr + disPos, newArr + disPos + numAdd);
+			_deallocate(newArr, newCap);
+			throw;
+		}
+	}
+	
+	/**
+	 * @brief move the live elements into a new buffer, leaving a gap of numAdd slots at disPos. when the elements
+	 * are copied, none of the old ones is destroyed before every copy is made, so a throwing copy leaves the old
+	 * buffer as it was and the new one empty
+	 * @param from the old buffer
+	 * @param to the new buffer
+	 * @param disPos index of the first slot of the gap
+	 * @param numAdd size of the gap
+	 */
+	VL_CONSTEXPR void _relocateAround(T *from, T *to, size_t disPos, size_t numAdd)
+	{
+		if constexpr (_bytewise || std::is_nothrow_move_constructible<T>::value ||
+					  !std::is_copy_constructible<T>::value)
+		{
+			_relocate(from, disPos, to);
+			_relocate(from + disPos, _size - disPos, to + disPos + numAdd);
+		}
+		else
+		{
+			size_t done = 0;
+			try
+			{
+				for (; done < _size; done++)
+				{
+					_construct(to + done + (done < disPos ? 0 : numAdd), from[done]);
+				}
+			}
+			catch (...)
+			{
+				std::destroy(to, to + std::min(done, disPos));
+				if (done > disPos)
+				{
+					std::destroy(to + disPos + numAdd, to + done + numAdd);
+				}
+				throw;
+			}
+			std::destroy(from, from + _size);
+		}
+	}
+	
+	/**
+	 * @brief move the live elements from the heap buffer into another one around a gap, and release the old one.
+	 * kept apart from the inline case so the compiler never sees the inline buffer being released
+	 * @param newArr the new heap buffer
+	 * @param newCap its capacity
+	 * @param disPos index of the first slot of the gap
+	 * @param numAdd size of the gap
+	 */
+	VL_CONSTEXPR void _heapToHeap(T *newArr, size_t newCap, size_t disPos, size_t numAdd)
+	{
+		T *oldArr = _data;
+		size_t oldCap = _heapCap;
+		_relocateAround(oldArr, newArr, disPos, numAdd);
+		_setHeap(newArr, newCap);
+		_deallocate(oldArr, oldCap);
+	}
+	
+	/**
+	 * @brief make room for newSize elements through the growth policy, like push_back. the shrink policy is not
+	 * asked, so a capacity the caller reserved is kept
+	 * @param newSize the size the vector is about to have
+	 */
+	VL_CONSTEXPR void _growFor(size_t newSize)
+	{
+		if (newSize > capacity())
+		{
+			_reallocWithGap(_capFor(newSize), _size, 0, [](T *) {});
+		}
+	}
+	
+	/**
+	 * @brief destroy the elements from index count on, the shrink policy may then give memory back
+	 * @param count the new size, at most _size
+	 */
+	VL_CONSTEXPR void _truncate(size_t count)
+	{
+		std::destroy(begin() + count, end());
+		_size = count;
+		_reCap(_size);
+	}
+	
+	/**
+	 * @brief move the live elements from the heap buffer to a smaller one, the stack if newCap is StaticCapacity
+	 * @param newCap the new capacity, at least _size
+	 */
+	void _shrinkTo(size_t newCap)
+	{
+		if (newCap <= StaticCapacity)
+		{
+			T *oldArr = _data;
+			size_t oldCap = _heapCap; // read it before the elements overwrite it
+			try
+			{
+				_relocate(oldArr, _size, _stack());
+			}
+			catch (...) // the copies are undone, but their bytes went over the capacity
+			{
+				_heapCap = oldCap;
+				throw;
+			}
+			_data = _stack();
+			_deallocate(oldArr, oldCap);
+			return;
+		}
+		if constexpr (_useRealloc)
+		{
+			_setHeap(_alloc.reallocate(_data, _heapCap, newCap), newCap);
+		}
+		else
+		{
+			T *newArr = _allocate(newCap);
+			try
+			{
+				_heapToHeap(newArr, newCap, _size, 0);
+			}
+			catch (...)
+			{
+				_deallocate(newArr, newCap);
+				throw;
+			}
+		}
+	}
+	
+	/**
+	 * @brief destroy every element and give the heap buffer back, the vector is left empty on the stack
+	 */
+	void _release() noexcept
 	{
-		return;
+		std::destroy(begin(), end());
+		_size = 0;
+		if (_onHeap())
+		{
+			_deallocate(_data, _heapCap);
+			_data = _stack();
+		}
 	}
-	if (_capacity == StaticCapacity) // we on the stack
+	
+	/**
+	 * @brief move a full size vector into the empty inline state of this one
+	 * @param other the vector to take from, left empty on the stack
+	 */
+	VL_CONSTEXPR void _steal(VLVector &other) noexcept(std::is_nothrow_move_constructible<T>::value)
 	{
-		if (_size <= _capacity) // no need to do anything
+		if (other._onHeap()) // take the heap buffer as is
 		{
-			return; // no need to reAlloc
+			_setHeap(other._data, other._heapCap);
+			other._init();
 		}
-		else // size > _capacity = StaticCapacity -> we need to go to the heap
+		else
 		{
-			size_t newCap = capfunc(_size, StaticCapacity, _capacity);
-			heapArr = new T[newCap];
-			std::copy(stackArr, stackArr + prevSize, heapArr);
-			_capacity = newCap;
+			_relocate(other._stack(), other._size, _stack());
 		}
+		_size = other._size;
+		other._size = 0;
 	}
-	else if (_capacity > StaticCapacity) // we are on the heap now
+	
+	/**
+	 * @brief open a gap of numAdd slots at disPos inside the current buffer, which has room for them, and fill
+	 * it. _size grows only once every slot holds an element - if a move throws, the slots built past the old
+	 * end are destroyed again and the size stays, the elements from disPos on may then be moved-from
+	 * @tparam Get callable, get(i) gives the i-th new element as an rvalue
+	 * @param disPos index of the gap
+	 * @param numAdd size of the gap
+	 * @param get gives the new elements
+	 */
+	template<class Get>
+	VL_CONSTEXPR void _insertInPlace(size_t disPos, size_t numAdd, Get &&get)
 	{
-		if (_size >= _capacity) // we need to increase the amount of memory
+		size_t orgSize = _size;
+		size_t top = orgSize + numAdd;
+		T *arr = begin();
+		if constexpr (_bytewise)
+		{
+			if (!_constEval()) // the tail slides as bytes, the gap is raw memory
+			{
+				std::memmove(static_cast<void *>(arr + disPos + numAdd), static_cast<const void *>(arr + disPos),
+							 (orgSize - disPos) * sizeof(T));
+				size_t i = 0;
+				try
+				{
+					for (; i < numAdd; i++)
+					{
+						_construct(arr + disPos + i, get(i));
+					}
+				}
+				catch (...) // close the gap again
+				{
+					std::destroy(arr + disPos, arr + disPos + i);
+					std::memmove(static_cast<void *>(arr + disPos), static_cast<const void *>(arr + disPos + numAdd),
+								 (orgSize - disPos) * sizeof(T));
+					throw;
+				}
+				_size = top;
+				return;
+			}
+		}
+		size_t tailBuilt = top; // the shifted slots [tailBuilt, top) past the old end hold elements
+		size_t gapBuilt = orgSize; // so do the gap slots [orgSize, gapBuilt), when the gap reaches past it
+		try
 		{
-			_capacity = capfunc(_size, StaticCapacity, _capacity);
-			auto newArr = new T[_capacity];
-			std::copy(heapArr, heapArr + prevSize, newArr);
-			if (heapArr)
+			for (size_t i = orgSize; i > disPos; i--)
 			{
-				delete[] (heapArr);
+				size_t to = i - 1 + numAdd;
+				if (to >= orgSize)
+				{
+					_construct(arr + to, std::move(arr[i - 1]));
+					tailBuilt = to;
+				}
+				else
+				{
+					arr[to] = std::move(arr[i - 1]);
+				}
 			}
-			heapArr = newArr;
+			for (size_t i = 0; i < numAdd; i++)
+			{
+				size_t to = disPos + i;
+				if (to >= orgSize)
+				{
+					_construct(arr + to, get(i));
+					gapBuilt = to + 1;
+				}
+				else
+				{
+					arr[to] = get(i);
+				}
+			}
+		}
+		catch (...)
+		{
+			std::destroy(arr + tailBuilt, arr + top);
+			std::destroy(arr + orgSize, arr + gapBuilt);
+			throw;
+		}
+		_size = top;
+	}
+	
+	/**
+	 * @brief slide the bytes of the live elements [from, _size) so they start at index to
+	 * @param from index of the first element to move
+	 * @param to its new index
+	 */
+	void _memmoveTail(size_t from, size_t to) noexcept
+	{
+		if (from < _size)
+		{
+			std::memmove(static_cast<void *>(begin() + to), static_cast<const void *>(begin() + from),
+						 (_size - from) * sizeof(T));
+		}
+	}
+};
+
+/**
+ * @brief private function that change the memory location and size if we need to.
+ * allocate or delete the heap memory. the _size live elements are moved to the new location.
+ * @tparam T the type of the vector elements
+ * @tparam StaticCapacity
+ * @tparam GrowthPolicy
+ * @tparam ShrinkPolicy
+ * @tparam Allocator
+ * @param newSize the size the vector is about to have
+ */
+template<typename T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+VL_CONSTEXPR void
+VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator>::_reCap(size_t newSize) // we know the new size
+{
+	if (newSize > capacity()) // we need to increase the amount of memory, stack to heap or a bigger heap
+	{
+		_reallocWithGap(_capFor(newSize), _size, 0, [](T *) {});
+	}
+	else if (!_constEval() && _onHeap() && ShrinkPolicy::shrink(newSize, _heapCap)) // the heap is mostly empty
+	{
+		if (newSize <= StaticCapacity) // we need to go back to the stack
+		{
+			_shrinkTo(StaticCapacity);
 		}
-		else if (_size <= StaticCapacity) // we need to go back to the stack
+		else // a smaller heap buffer that still leaves room to grow
 		{
-			_capacity = StaticCapacity;
-			std::copy(heapArr, heapArr + _size, stackArr);
-			if (heapArr)
+			size_t newCap = std::max(newSize, GrowthPolicy::grow(newSize, newSize, sizeof(T)));
+			if (newCap < _heapCap)
 			{
-				delete[] (heapArr);
-				heapArr = nullptr;
+				_shrinkTo(newCap);
 			}
 		}
 	}
@@ -542,21 +1827,54 @@ void VLVector<T, StaticCapacity>::_reCap(size_t prevSize) // we know the new siz
 
 /**
  * @brief The function calculates the current capacity corresponding to the new size using the previous and static
- * capacity.
+ * capacity, the growth policy is asked only when the current capacity is too small.
+ * @tparam T the type of the vector elements
+ * @tparam StaticCapacity
+ * @tparam GrowthPolicy
+ * @tparam ShrinkPolicy
+ * @tparam Allocator
  * @param s the new vector's size.
- * @param stat the static capacity - constant.
- * @param nowCap the old capacity suited for the old size.
  * @return new current capacity.
  */
-static size_t capfunc(size_t s, int stat, size_t nowCap)
+template<typename T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+VL_CONSTEXPR size_t VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator>::_capFor(size_t s) const
 {
-	if (s <= (size_t) stat)
+	if (s <= StaticCapacity)
 	{
-		return stat;
+		return StaticCapacity;
 	}
+	size_t nowCap = capacity();
 	if (s <= nowCap)
 	{
 		return nowCap;
 	}
-	return (3 * (s)) / 2;
+	if (s > max_size())
+	{
+		throw std::length_error("VLVector too long");
+	}
+	return std::min(max_size(), std::max(s, GrowthPolicy::grow(s, nowCap, sizeof(T))));
+}
+
+/**
+ * @brief exchange the content of two vectors, see VLVector::swap
+ * @param lhs left hand side
+ * @param rhs right hand side
+ */
+template<typename T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+void swap(VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &lhs,
+		  VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &rhs)
+{
+	lhs.swap(rhs);
+}
+
+namespace pmr
+{
+	/**
+	 * @brief VLVector whose heap buffers come from a std::pmr::memory_resource
+	 */
+	template<class T, unsigned long StaticCapacity = DEFAULT_STATIC_CAPACITY, class GrowthPolicy = GrowOneAndHalf,
+			class ShrinkPolicy = ShrinkBelowWatermark<>>
+	using VLVector = ::VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, std::pmr::polymorphic_allocator<T>>;
 }
+
+#endif // VLVECTOR_HPP
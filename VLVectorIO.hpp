@@ -0,0 +1,508 @@
+/**
+ * @file    VLVectorIO.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Binary serialization of VLVectors.
+ */
+
+#ifndef VLVECTORIO_HPP
+#define VLVECTORIO_HPP
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "VLVector.hpp"
+
+/**
+ * the stream format, in native byte order:
+ *     VLStreamHeader                      32 bytes
+ *     payload                             count elements, either
+ *         raw                             count * elemSize bytes, for trivially copyable elements
+ *         length-prefixed                 count * (uint64_t length, length bytes), for the others
+ *     uint64_t checksum                   FNV-1a of the payload, only if VL_STREAM_CHECKSUM is set
+ */
+#define VL_STREAM_MAGIC 0x53564c56u // "VLVS"
+#define VL_STREAM_VERSION 1u
+#define VL_STREAM_PREFIXED 1u
+#define VL_STREAM_CHECKSUM 2u
+#define VL_STREAM_CHUNK_SIZE (64u * 1024u)
+
+/**
+ * @brief the header in front of every serialized vector
+ */
+struct VLStreamHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t flags;
+	uint32_t elemSize; // sizeof of the element type, 0 for length-prefixed elements
+	uint32_t reserved;
+	uint64_t count;
+	uint64_t padding; // keeps the payload 32-byte aligned for views
+};
+
+/**
+ * @brief tells how an element that is not trivially copyable turns into bytes and back. specialize it for
+ * your types with
+ *     static size_t size(const T &val) - the number of bytes val takes
+ *     static void save(const T &val, unsigned char *out) - write them
+ *     static T load(const unsigned char *in, size_t n) - rebuild an element from n bytes
+ * @tparam T the type of the elements
+ */
+template<class T>
+struct VLSerializer;
+
+/**
+ * @brief strings of trivially copyable characters are saved as their characters
+ */
+template<class CharT, class Traits, class Alloc>
+struct VLSerializer<std::basic_string<CharT, Traits, Alloc>>
+{
+	typedef std::basic_string<CharT, Traits, Alloc> string_type;
+	
+	static size_t size(const string_type &val) { return val.size() * sizeof(CharT); }
+	
+	static void save(const string_type &val, unsigned char *out) { std::memcpy(out, val.data(), size(val)); }
+	
+	static string_type load(const unsigned char *in, size_t n)
+	{
+		string_type val(n / sizeof(CharT), CharT());
+		std::memcpy(static_cast<void *>(&val[0]), in, n);
+		return val;
+	}
+};
+
+/**
+ * @brief 64-bit FNV-1a, fed piece by piece so it does not depend on how the payload was chunked
+ */
+class VLChecksum
+{
+public:
+	VLChecksum() : _hash(14695981039346656037ull) {}
+	
+	/**
+	 * @brief add bytes to the hash
+	 * @param p the bytes
+	 * @param n their number
+	 */
+	void update(const void *p, size_t n)
+	{
+		const unsigned char *bytes = static_cast<const unsigned char *>(p);
+		uint64_t hash = _hash;
+		for (size_t i = 0; i < n; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		_hash = hash;
+	}
+	
+	/**
+	 * @brief getter for the hash of everything added so far
+	 * @return the hash
+	 */
+	uint64_t value() const { return _hash; }
+
+private:
+	uint64_t _hash;
+};
+
+/**
+ * @brief writes VLVectors to a stream. the bytes gather in a chunk that goes out when full, payloads larger
+ * than a chunk skip it and go straight to the stream
+ */
+class VLVectorWriter
+{
+public:
+	/**
+	 * @brief creates a writer
+	 * @param out the stream to write to
+	 * @param checksum add a checksum after every payload
+	 * @param chunkSize the size of the chunks written to out
+	 */
+	explicit VLVectorWriter(std::ostream &out, bool checksum = false, size_t chunkSize = VL_STREAM_CHUNK_SIZE) :
+			_out(out), _checksum(checksum), _chunk(new unsigned char[chunkSize]), _chunkSize(chunkSize), _used(0) {}
+	
+	VLVectorWriter(VLVectorWriter const &other) = delete;
+	
+	VLVectorWriter &operator=(VLVectorWriter const &rhs) = delete;
+	
+	/**
+	 * @brief destructor - writes out what is left in the chunk
+	 */
+	~VLVectorWriter() { flush(); }
+	
+	/**
+	 * @brief serialize a vector
+	 * @param vec the vector
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+	void write(const VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &vec)
+	{
+		constexpr bool raw = std::is_trivially_copyable<T>::value;
+		VLStreamHeader header{VL_STREAM_MAGIC, VL_STREAM_VERSION,
+							  (uint16_t) ((raw ? 0u : VL_STREAM_PREFIXED) | (_checksum ? VL_STREAM_CHECKSUM : 0u)),
+							  raw ? (uint32_t) sizeof(T) : 0u, 0, vec.size(), 0};
+		_put(&header, sizeof(header));
+		VLChecksum sum;
+		if constexpr (raw)
+		{
+			_putPayload(sum, vec.data(), vec.size() * sizeof(T));
+		}
+		else
+		{
+			std::string bytes;
+			for (const T &val : vec)
+			{
+				uint64_t length = VLSerializer<T>::size(val);
+				bytes.resize(length);
+				VLSerializer<T>::save(val, reinterpret_cast<unsigned char *>(&bytes[0]));
+				_putPayload(sum, &length, sizeof(length));
+				_putPayload(sum, bytes.data(), length);
+			}
+		}
+		if (_checksum)
+		{
+			uint64_t value = sum.value();
+			_put(&value, sizeof(value));
+		}
+	}
+	
+	/**
+	 * @brief write out the chunk
+	 */
+	void flush()
+	{
+		if (_used > 0)
+		{
+			_out.write(reinterpret_cast<const char *>(_chunk.get()), (std::streamsize) _used);
+			_used = 0;
+		}
+		_out.flush();
+	}
+
+private:
+	std::ostream &_out;
+	bool _checksum;
+	std::unique_ptr<unsigned char[]> _chunk;
+	size_t _chunkSize;
+	size_t _used; // bytes waiting in the chunk
+	
+	/**
+	 * @brief append bytes to the output
+	 * @param p the bytes
+	 * @param n their number
+	 */
+	void _put(const void *p, size_t n)
+	{
+		if (_used + n > _chunkSize && _used > 0)
+		{
+			_out.write(reinterpret_cast<const char *>(_chunk.get()), (std::streamsize) _used);
+			_used = 0;
+		}
+		if (n >= _chunkSize)
+		{
+			_out.write(static_cast<const char *>(p), (std::streamsize) n);
+			return;
+		}
+		std::memcpy(_chunk.get() + _used, p, n);
+		_used += n;
+	}
+	
+	/**
+	 * @brief append payload bytes to the output, feeding the checksum if there is one
+	 * @param sum the checksum of the payload
+	 * @param p the bytes
+	 * @param n their number
+	 */
+	void _putPayload(VLChecksum &sum, const void *p, size_t n)
+	{
+		if (_checksum)
+		{
+			sum.update(p, n);
+		}
+		_put(p, n);
+	}
+};
+
+/**
+ * @brief reads VLVectors that a VLVectorWriter wrote, copying them into vectors
+ */
+class VLVectorReader
+{
+public:
+	/**
+	 * @brief creates a reader
+	 * @param in the stream to read from
+	 */
+	explicit VLVectorReader(std::istream &in) : _in(in) {}
+	
+	/**
+	 * @brief deserialize the next vector in the stream, replacing the contents of vec. the checksum is verified
+	 * if the writer added one. throws std::runtime_error if the stream does not hold a vector of T, or its
+	 * header claims more elements than the stream (when it can seek) or the vector can hold. on a stream of
+	 * unknown length memory is taken chunk by chunk as the payload arrives, never up front from the header
+	 * @param vec the vector to fill
+	 */
+	template<class T, unsigned long StaticCapacity, class GrowthPolicy, class ShrinkPolicy, class Allocator>
+	void read(VLVector<T, StaticCapacity, GrowthPolicy, ShrinkPolicy, Allocator> &vec)
+	{
+		constexpr bool raw = std::is_trivially_copyable<T>::value;
+		VLStreamHeader header{};
+		_get(&header, sizeof(header));
+		if (header.magic != VL_STREAM_MAGIC || header.version != VL_STREAM_VERSION ||
+			((header.flags & VL_STREAM_PREFIXED) == 0) != raw || (raw && header.elemSize != sizeof(T)))
+		{
+			throw std::runtime_error("the stream does not hold a vector of this type");
+		}
+		bool checked = (header.flags & VL_STREAM_CHECKSUM) != 0;
+		uint64_t left = _remaining();
+		uint64_t minElem = raw ? sizeof(T) : sizeof(uint64_t); // the fewest bytes an element takes in the stream
+		if (header.count > vec.max_size() || header.count > left / minElem)
+		{
+			throw std::runtime_error("the header claims more elements than the stream holds");
+		}
+		bool known = left != std::numeric_limits<uint64_t>::max();
+		VLChecksum sum;
+		vec.clear();
+		if constexpr (raw) // the bytes go straight into the free capacity, they are the elements
+		{
+			size_t batch = known ? header.count : std::max<size_t>(1, VL_STREAM_CHUNK_SIZE / sizeof(T));
+			vec.reserve(known ? header.count : 0);
+			for (size_t done = 0; done < header.count; done += batch)
+			{
+				size_t num = std::min<size_t>(batch, header.count - done);
+				T *added = vec.append_uninitialized(num); // by the growth policy, batches of an unknown length add up
+				try
+				{
+					_get(added, num * sizeof(T));
+				}
+				catch (...) // the unread elements never got their bytes
+				{
+					vec.erase(vec.begin() + done, vec.end());
+					throw;
+				}
+				if (checked)
+				{
+					sum.update(added, num * sizeof(T));
+				}
+			}
+		}
+		else
+		{
+			vec.reserve(known ? header.count : std::min<uint64_t>(header.count, VL_STREAM_CHUNK_SIZE / minElem));
+			left -= known ? header.count * minElem : 0; // what is left for the element bytes
+			std::string bytes;
+			for (uint64_t i = 0; i < header.count; i++)
+			{
+				uint64_t length = 0;
+				_get(&length, sizeof(length));
+				if (length > left || length > bytes.max_size())
+				{
+					throw std::runtime_error("unexpected end of stream");
+				}
+				left -= known ? length : 0;
+				_getBytes(bytes, length);
+				if (checked)
+				{
+					sum.update(&length, sizeof(length));
+					sum.update(bytes.data(), length);
+				}
+				vec.push_back(VLSerializer<T>::load(reinterpret_cast<const unsigned char *>(bytes.data()), length));
+			}
+		}
+		if (checked)
+		{
+			uint64_t value = 0;
+			_get(&value, sizeof(value));
+			if (value != sum.value())
+			{
+				throw std::runtime_error("checksum mismatch");
+			}
+		}
+	}
+
+private:
+	std::istream &_in;
+	
+	/**
+	 * @brief read exactly n bytes
+	 * @param p where to put them
+	 * @param n their number
+	 */
+	void _get(void *p, size_t n)
+	{
+		if (!_in.read(static_cast<char *>(p), (std::streamsize) n))
+		{
+			throw std::runtime_error("unexpected end of stream");
+		}
+	}
+	
+	/**
+	 * @brief read n bytes into a string, growing it a chunk at a time - on a stream of unknown length a bogus n
+	 * then runs out of bytes before it runs out of memory
+	 * @param bytes the string to fill
+	 * @param n the number of bytes
+	 */
+	void _getBytes(std::string &bytes, uint64_t n)
+	{
+		bytes.clear();
+		while (bytes.size() < n)
+		{
+			size_t done = bytes.size();
+			size_t num = (size_t) std::min<uint64_t>(n - done, VL_STREAM_CHUNK_SIZE);
+			bytes.resize(done + num);
+			_get(&bytes[done], num);
+		}
+	}
+	
+	/**
+	 * @brief the number of bytes left in the stream, found by seeking to its end and back
+	 * @return the bytes left, or the largest uint64_t if the stream cannot seek (a pipe, a socket)
+	 */
+	uint64_t _remaining()
+	{
+		std::istream::pos_type here = _in.tellg();
+		if (here == std::istream::pos_type(-1))
+		{
+			return std::numeric_limits<uint64_t>::max();
+		}
+		_in.seekg(0, std::ios::end);
+		std::istream::pos_type end = _in.tellg();
+		_in.seekg(here);
+		if (end == std::istream::pos_type(-1) || !_in)
+		{
+			_in.clear();
+			_in.seekg(here);
+			return std::numeric_limits<uint64_t>::max();
+		}
+		return (uint64_t) (end - here);
+	}
+};
+
+/**
+ * @brief read-only view of a serialized vector of trivially copyable elements, right in the buffer that holds
+ * it - nothing is copied
+ * @tparam T the type of the elements
+ */
+template<class T>
+class VLVectorView
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only raw payloads can be viewed in place");
+
+public:
+	typedef const T *const_iterator;
+	typedef T value_type;
+	
+	/**
+	 * @brief attach to a serialized vector, verifying its checksum if it has one and verify is set.
+	 * throws std::runtime_error if the buffer does not hold a vector of T, or the payload is not aligned for T
+	 * @param buf the buffer, it must outlive the view
+	 * @param len its size in bytes
+	 * @param verify check the checksum (one pass over the payload)
+	 */
+	VLVectorView(const void *buf, size_t len, bool verify = true)
+	{
+		VLStreamHeader header{};
+		if (len < sizeof(header))
+		{
+			throw std::runtime_error("unexpected end of buffer");
+		}
+		std::memcpy(&header, buf, sizeof(header));
+		if (header.magic != VL_STREAM_MAGIC || header.version != VL_STREAM_VERSION ||
+			(header.flags & VL_STREAM_PREFIXED) != 0 || header.elemSize != sizeof(T))
+		{
+			throw std::runtime_error("the buffer does not hold a vector of this type");
+		}
+		bool checked = (header.flags & VL_STREAM_CHECKSUM) != 0;
+		if (header.count > (len - sizeof(header)) / sizeof(T)) // checked before multiplying, count * sizeof(T) may wrap
+		{
+			throw std::runtime_error("unexpected end of buffer");
+		}
+		size_t payload = header.count * sizeof(T);
+		if (len - sizeof(header) < payload + (checked ? sizeof(uint64_t) : 0))
+		{
+			throw std::runtime_error("unexpected end of buffer");
+		}
+		const unsigned char *first = static_cast<const unsigned char *>(buf) + sizeof(header);
+		if (reinterpret_cast<uintptr_t>(first) % alignof(T) != 0)
+		{
+			throw std::runtime_error("the payload is not aligned for this type");
+		}
+		if (checked && verify)
+		{
+			VLChecksum sum;
+			sum.update(first, payload);
+			uint64_t value = 0;
+			std::memcpy(&value, first + payload, sizeof(value));
+			if (value != sum.value())
+			{
+				throw std::runtime_error("checksum mismatch");
+			}
+		}
+		_data = reinterpret_cast<const T *>(first);
+		_size = header.count;
+	}
+	
+	/**
+	 * @brief getter for size attribute
+	 * @return size
+	 */
+	size_t size() const { return _size; }
+	
+	/**
+	 * @brief checks if the view is empty
+	 * @return if empty - true, otherwise - false
+	 */
+	bool empty() const { return _size == 0; }
+	
+	/**
+	 * @brief getter for the elements
+	 * @return pointer to the first element
+	 */
+	const T *data() const { return _data; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &operator[](const size_t &idx) const { return _data[idx]; }
+	
+	/**
+	 * @brief access the requested index and returns the value found in it,
+	 * while verifying that the index is in the view range
+	 * @param idx index to access
+	 * @return read-only value in given access
+	 */
+	const T &at(const size_t idx) const
+	{
+		if (idx < _size)
+		{
+			return (*this)[idx];
+		}
+		else
+		{
+			throw std::out_of_range("index out of range");
+		}
+	}
+	
+	/**
+	 * @brief
+	 * @return const iterator to the view's begin
+	 */
+	const_iterator begin() const { return _data; }
+	
+	/**
+	 * @brief
+	 * @return const iterator to the view's end
+	 */
+	const_iterator end() const { return _data + _size; }
+
+private:
+	const T *_data;
+	size_t _size;
+};
+
+#endif // VLVECTORIO_HPP
@@ -0,0 +1,124 @@
+/**
+ * @file    par_scaling.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Scaling benchmark of the par:: algorithms of VLParallel.hpp.
+ *
+ * usage: par_scaling [elements] [max threads]
+ * every algorithm runs on VLThreadPools of 1, 2, 4 ... max threads (the core count by default), best of
+ * VL_BENCH_REPEATS runs, and the speedup over one thread is printed next to it. par::sort ends with a merge
+ * round of a single pair, which one thread does alone - its time is printed as "sort last merge", and the
+ * "sort bound" column is the speedup Amdahl's law leaves sort with that merge serial.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "../VLParallel.hpp"
+
+#define VL_BENCH_REPEATS 3
+
+typedef VLVector<double> BenchVector;
+
+/**
+ * @brief time a callable, best of VL_BENCH_REPEATS runs
+ * @param prepare called before every run, not timed
+ * @param run the timed part
+ * @return the best time in milliseconds
+ */
+template<class Prepare, class Run>
+double bestOf(Prepare prepare, Run run)
+{
+	double best = 0;
+	for (int i = 0; i < VL_BENCH_REPEATS; i++)
+	{
+		prepare();
+		auto start = std::chrono::steady_clock::now();
+		run();
+		std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - start;
+		if (i == 0 || took.count() < best)
+		{
+			best = took.count();
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief one row of the table
+ * @param name the algorithm
+ * @param threads the pool size
+ * @param ms its time
+ * @param serialMs the time on one thread
+ */
+void report(const char *name, unsigned threads, double ms, double serialMs)
+{
+	std::printf("%-18s %7u %10.2f %8.2fx\n", name, threads, ms, serialMs / ms);
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (size_t) 1 << 24;
+	unsigned maxThreads = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10)
+								   : std::max(std::thread::hardware_concurrency(), 1u);
+	BenchVector input;
+	input.reserve(n);
+	std::mt19937_64 gen(42);
+	std::uniform_real_distribution<double> dist(0, 1);
+	for (size_t i = 0; i < n; i++)
+	{
+		input.push_back(dist(gen));
+	}
+	BenchVector work;
+	BenchVector out;
+	
+	std::printf("%zu doubles, 1 to %u threads, best of %d\n\n", n, maxThreads, VL_BENCH_REPEATS);
+	std::printf("%-18s %7s %10s %9s\n", "algorithm", "threads", "ms", "speedup");
+	double serial[6] = {};
+	for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+	{
+		VLThreadPool pool(threads);
+		double ms[6];
+		ms[0] = bestOf([&] { par::copy(input, work, pool); }, [&]
+		{
+			par::for_each(work, [](double &x) { x = x * x + 1; }, pool);
+		});
+		ms[1] = bestOf([] {}, [&]
+		{
+			par::transform(input, out, [](double x) { return x * 2 + 1; }, pool);
+		});
+		ms[2] = bestOf([] {}, [&] { par::copy(input, out, pool); });
+		volatile double sum = 0;
+		ms[3] = bestOf([] {}, [&] { sum = par::reduce(input, 0.0, std::plus<double>(), pool); });
+		ms[4] = bestOf([&] { work = input; }, [&] { par::sort(work, std::less<double>(), pool); });
+		// the last round of par::sort: one inplace_merge of the two sorted halves, on the calling thread
+		ms[5] = bestOf([&]
+		{
+			work = input;
+			std::sort(work.begin(), work.begin() + n / 2);
+			std::sort(work.begin() + n / 2, work.end());
+		}, [&]
+		{
+			std::inplace_merge(work.begin(), work.begin() + n / 2, work.end());
+		});
+		const char *names[6] = {"for_each", "transform", "copy", "reduce", "sort", "sort last merge"};
+		for (int i = 0; i < 6; i++)
+		{
+			if (threads == 1)
+			{
+				serial[i] = ms[i];
+			}
+			report(names[i], threads, ms[i], serial[i]);
+		}
+		double mergeShare = serial[5] / serial[4]; // the part of a serial sort that never gets faster
+		std::printf("%-18s %7u %21.2fx\n\n", "sort bound", threads, 1 / (mergeShare + (1 - mergeShare) / threads));
+		if (threads == maxThreads)
+		{
+			break;
+		}
+	}
+	return 0;
+}
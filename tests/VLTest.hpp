@@ -0,0 +1,91 @@
+/**
+ * @file    VLTest.hpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Minimal checks for the VLVector tests, they stay on in release builds.
+ */
+
+#ifndef VLTEST_HPP
+#define VLTEST_HPP
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief count of the failed checks of the running test binary
+ */
+inline int &vlFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+/**
+ * @brief the registered tests, run in order by vlRunTests
+ */
+inline std::vector<std::pair<const char *, std::function<void()>>> &vlTests()
+{
+	static std::vector<std::pair<const char *, std::function<void()>>> tests;
+	return tests;
+}
+
+/**
+ * @brief registers a test at static initialization
+ */
+struct VLTestRegistrar
+{
+	VLTestRegistrar(const char *name, std::function<void()> body) { vlTests().emplace_back(name, std::move(body)); }
+};
+
+#define VL_TEST(name) \
+	static void name(); \
+	static VLTestRegistrar name##_registrar(#name, name); \
+	static void name()
+
+#define VL_CHECK(cond) \
+	do \
+	{ \
+		if (!(cond)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			vlFailures()++; \
+		} \
+	} while (0)
+
+#define VL_CHECK_THROWS(expr, Exception) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			expr; \
+		} \
+		catch (const Exception &) \
+		{ \
+			thrown = true; \
+		} \
+		if (!thrown) \
+		{ \
+			std::fprintf(stderr, "%s:%d: %s did not throw %s\n", __FILE__, __LINE__, #expr, #Exception); \
+			vlFailures()++; \
+		} \
+	} while (0)
+
+/**
+ * @brief run every registered test
+ * @return the exit code, 0 if every check passed
+ */
+inline int vlRunTests()
+{
+	for (auto &test : vlTests())
+	{
+		int before = vlFailures();
+		test.second();
+		std::printf("%-40s %s\n", test.first, vlFailures() == before ? "ok" : "FAILED");
+	}
+	return vlFailures() == 0 ? 0 : 1;
+}
+
+#endif // VLTEST_HPP
@@ -0,0 +1,93 @@
+/**
+ * @file    arena_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the bump-pointer arena and the vectors that use it.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+#include "../VLArena.hpp"
+#include "VLTest.hpp"
+
+VL_TEST(arenaAlignsPastAFullChunk)
+{
+	VLArena arena(1001);
+	arena.allocate(1001, 1); // the chunk is full, aligning _cur steps past its end
+	unsigned char *block = static_cast<unsigned char *>(arena.allocate(8, 8));
+	VL_CHECK(reinterpret_cast<uintptr_t>(block) % 8 == 0);
+	std::memset(block, 1, 8);
+	VL_CHECK(arena.reserved() >= 1001 + 8);
+}
+
+VL_TEST(arenaMixedAlignments)
+{
+	VLArena arena(64);
+	for (size_t i = 0; i < 200; i++)
+	{
+		size_t align = size_t(1) << (i % 7);
+		size_t bytes = i % 13 + 1;
+		unsigned char *block = static_cast<unsigned char *>(arena.allocate(bytes, align));
+		VL_CHECK(reinterpret_cast<uintptr_t>(block) % align == 0);
+		std::memset(block, (int) i, bytes);
+	}
+}
+
+VL_TEST(arenaSizesDoNotWrap)
+{
+	VLArena arena(64);
+	VL_CHECK_THROWS(arena.allocate(std::numeric_limits<size_t>::max() - 4, 8), std::bad_alloc);
+	VL_CHECK_THROWS(VLArenaAllocator<double>(arena).allocate(std::numeric_limits<size_t>::max() / 4),
+					std::bad_array_new_length);
+}
+
+VL_TEST(insertRangeIntoArenaVector)
+{
+	VLArena arena(1024);
+	ArenaVLVector<std::string, 2> vec{VLArenaAllocator<std::string>(arena)};
+	std::vector<std::string> values{"a", "b", "c"};
+	vec.insert(vec.begin(), values.begin(), values.end());
+	vec.insert(vec.begin() + 1, values.begin(), values.end());
+	VL_CHECK(vec.size() == 6 && vec[1] == "a" && vec[5] == "c");
+}
+
+VL_TEST(arenaVectorGrowsInPlace)
+{
+	VLArena arena(4096);
+	ArenaVLVector<int, 2> vec{VLArenaAllocator<int>(arena)};
+	vec.reserve(8);
+	const int *buffer = vec.data();
+	for (int i = 0; i < 100; i++) // the newest block is extended, nothing is copied
+	{
+		vec.push_back(i);
+	}
+	VL_CHECK(vec.data() == buffer && vec[99] == 99);
+	VL_CHECK(arena.reserved() == 4096);
+}
+
+VL_TEST(resetKeepsTheNewestChunk)
+{
+	VLArena arena(256);
+	for (int round = 0; round < 3; round++)
+	{
+		ArenaVLVector<double, 2> vec{VLArenaAllocator<double>(arena)};
+		for (int i = 0; i < 200; i++)
+		{
+			vec.push_back(i);
+		}
+		VL_CHECK(vec[199] == 199);
+	}
+	size_t held = arena.reserved();
+	arena.reset();
+	VL_CHECK(arena.reserved() <= held && arena.reserved() > 0);
+	void *first = arena.allocate(16, 8);
+	arena.reset();
+	VL_CHECK(arena.allocate(16, 8) == first); // the batch starts over in the same memory
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,207 @@
+/**
+ * @file    bitvector_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the bit-packed vector, against std::vector<bool>.
+ */
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../VLBitVector.hpp"
+#include "VLTest.hpp"
+
+typedef VLBitVector<128> Bits; // two inline words
+
+/**
+ * @brief checks bits against the model - every bit, the word operations, and that the bits past the size in
+ * the last word are zero
+ */
+static bool sameBits(const Bits &bits, const std::vector<bool> &model)
+{
+	size_t n = model.size();
+	bool ok = bits.size() == n && bits.capacity() >= n && bits.word_count() == (n + 63) / 64;
+	size_t set = 0;
+	for (size_t i = 0; ok && i < n; i++)
+	{
+		ok = bits[i] == model[i];
+		set += model[i];
+	}
+	if (n % 64 != 0)
+	{
+		ok = ok && (bits.words()[n / 64] >> (n % 64)) == 0;
+	}
+	size_t firstSet = n, firstClear = n;
+	for (size_t i = n; i-- > 0;)
+	{
+		(model[i] ? firstSet : firstClear) = i;
+	}
+	ok = ok && bits.count() == set && bits.count(false) == n - set;
+	ok = ok && bits.all() == (set == n) && bits.any() == (set != 0) && bits.none() == (set == 0);
+	ok = ok && bits.find_first() == firstSet && (size_t) (bits.find(false) - bits.begin()) == firstClear;
+	size_t walked = 0;
+	for (size_t i = bits.find_first(); i < n; i = bits.find_next(i))
+	{
+		ok = ok && model[i];
+		walked++;
+	}
+	return ok && walked == set;
+}
+
+VL_TEST(randomOperationsMatchTheModel)
+{
+	std::mt19937 rng(23);
+	Bits bits;
+	std::vector<bool> model;
+	bool ok = true;
+	bool wentToHeap = false, cameBack = false;
+	for (int step = 0; step < 4000 && ok; step++)
+	{
+		switch (rng() % 6)
+		{
+			case 0:
+			case 1:
+			{
+				bool bit = rng() % 3 != 0;
+				bits.push_back(bit);
+				model.push_back(bit);
+				break;
+			}
+			case 2:
+				bits.pop_back();
+				if (!model.empty())
+				{
+					model.pop_back();
+				}
+				break;
+			case 3:
+			{
+				size_t count = rng() % 300;
+				bool val = rng() % 2 == 0;
+				bits.resize(count, val);
+				model.resize(count, val);
+				break;
+			}
+			case 4:
+				bits.flip();
+				model.flip();
+				break;
+			default:
+				if (!model.empty())
+				{
+					size_t i = rng() % model.size();
+					bits[i] = !bits[i];
+					model[i] = !model[i];
+				}
+		}
+		wentToHeap = wentToHeap || bits.capacity() > 128;
+		cameBack = cameBack || (wentToHeap && bits.capacity() == 128);
+		ok = sameBits(bits, model);
+	}
+	VL_CHECK(ok && wentToHeap && cameBack);
+}
+
+VL_TEST(tailIsClearedOnTheWayDown)
+{
+	Bits bits(200, true);
+	bits.pop_back();
+	bits.resize(100);
+	bits.resize(200); // the bits that come back must be the new value, not the old ones
+	std::vector<bool> model(200, false);
+	std::fill(model.begin(), model.begin() + 100, true);
+	VL_CHECK(sameBits(bits, model));
+	bits.resize(70);
+	bits.push_back(false);
+	model.resize(70);
+	model.push_back(false);
+	VL_CHECK(sameBits(bits, model));
+}
+
+VL_TEST(allAndCountAcrossWordBoundaries)
+{
+	for (size_t n : {1, 63, 64, 65, 127, 128, 129, 1000})
+	{
+		Bits bits(n, true);
+		VL_CHECK(bits.all() && bits.count() == n && bits.find(false) == bits.end());
+		bits[n - 1] = false;
+		VL_CHECK(!bits.all() && bits.count() == n - 1 && bits.find(false) == bits.begin() + (n - 1));
+		bits.flip();
+		VL_CHECK(bits.count() == 1 && bits.find_first() == n - 1 && bits.find_next(n - 1) == n);
+	}
+}
+
+VL_TEST(movesBetweenInlineAndHeapKeepTheBits)
+{
+	std::vector<bool> model;
+	Bits bits;
+	for (size_t i = 0; i < 100; i++)
+	{
+		model.push_back(i % 3 == 0);
+		bits.push_back(i % 3 == 0);
+	}
+	bits.reserve(1000); // inline to heap
+	VL_CHECK(bits.capacity() >= 1000 && sameBits(bits, model));
+	bits.shrink_to_fit(); // heap back to inline
+	VL_CHECK(bits.capacity() == 128 && sameBits(bits, model));
+	Bits moved(std::move(bits));
+	VL_CHECK(sameBits(moved, model) && bits.empty());
+	moved.reserve(1000);
+	Bits stolen(std::move(moved));
+	VL_CHECK(sameBits(stolen, model) && moved.empty() && moved.capacity() == 128);
+}
+
+VL_TEST(growthKeepsTheReservedBuffer)
+{
+	Bits bits;
+	bits.reserve(10000);
+	size_t cap = bits.capacity();
+	const uint64_t *buffer = bits.words();
+	bits.push_back(true);
+	VL_CHECK(bits.capacity() == cap && bits.words() == buffer && bits.size() == 1 && bits[0]);
+	bits.resize(5000, true);
+	VL_CHECK(bits.capacity() == cap && bits.words() == buffer && bits.count() == 5000);
+	std::vector<bool> model(5000);
+	for (size_t i = 0; i < model.size(); i++)
+	{
+		model[i] = i % 7 == 0;
+	}
+	bits.assign(model.begin(), model.end());
+	VL_CHECK(bits.capacity() == cap && bits.words() == buffer && sameBits(bits, model));
+	bits.assign(3000, true);
+	VL_CHECK(bits.capacity() == cap && bits.words() == buffer && bits.count() == 3000);
+	
+	Bits assigned; // assign reserves once, the pushes after it keep that buffer
+	assigned.assign(model.begin(), model.end());
+	VL_CHECK(assigned.capacity() == 5056 && sameBits(assigned, model));
+}
+
+VL_TEST(bitwiseOperators)
+{
+	std::mt19937 rng(29);
+	for (size_t n : {0, 70, 500})
+	{
+		Bits a, b;
+		std::vector<bool> andModel, orModel, xorModel, notModel;
+		for (size_t i = 0; i < n; i++)
+		{
+			bool x = rng() % 2 == 0, y = rng() % 2 == 0;
+			a.push_back(x);
+			b.push_back(y);
+			andModel.push_back(x && y);
+			orModel.push_back(x || y);
+			xorModel.push_back(x != y);
+			notModel.push_back(!x);
+		}
+		VL_CHECK(sameBits(a & b, andModel) && sameBits(a | b, orModel) && sameBits(a ^ b, xorModel));
+		VL_CHECK(sameBits(~a, notModel));
+		Bits c = a;
+		c ^= a;
+		VL_CHECK(c.none() && c.size() == n);
+	}
+	Bits shorter(10, true), longer(11, true);
+	VL_CHECK_THROWS(shorter & longer, std::invalid_argument);
+	VL_CHECK_THROWS(shorter |= longer, std::invalid_argument);
+}
+
+int main() { return vlRunTests(); }
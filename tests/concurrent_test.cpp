@@ -0,0 +1,116 @@
+/**
+ * @file    concurrent_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the lock-free append vector, also meant to be run under ThreadSanitizer.
+ */
+
+#include <atomic>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ConcurrentVLVector.hpp"
+#include "VLTest.hpp"
+
+/**
+ * @brief while set, FailingAllocator throws instead of allocating
+ */
+static std::atomic<bool> failAllocations(false);
+
+/**
+ * @brief VLAllocator that throws on demand, to run out of memory at a chosen append
+ */
+template<class T>
+struct FailingAllocator : VLAllocator<T>
+{
+	FailingAllocator() noexcept = default;
+	
+	template<class U>
+	FailingAllocator(const FailingAllocator<U> &) noexcept {}
+	
+	template<class U>
+	struct rebind
+	{
+		typedef FailingAllocator<U> other;
+	};
+	
+	T *allocate(size_t n)
+	{
+		if (failAllocations.load())
+		{
+			throw std::bad_alloc();
+		}
+		return VLAllocator<T>::allocate(n);
+	}
+};
+
+VL_TEST(manyProducersOneReader)
+{
+	const int producers = 4;
+	const int perProducer = 20000;
+	ConcurrentVLVector<long, 8> vec;
+	std::atomic<bool> done(false);
+	bool prefixOk = true;
+	std::thread reader([&]
+	{
+		while (!done.load())
+		{
+			size_t n = vec.size();
+			for (size_t i = 0; i < n; i++) // a published element is built, its value names its producer
+			{
+				prefixOk = prefixOk && vec[i] / perProducer < producers;
+			}
+		}
+	});
+	std::vector<std::thread> threads;
+	for (int t = 0; t < producers; t++)
+	{
+		threads.emplace_back([&vec, t]
+		{
+			for (int i = 0; i < perProducer; i++)
+			{
+				vec.push_back((long) t * perProducer + i);
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+	done.store(true);
+	reader.join();
+	VL_CHECK(prefixOk && vec.size() == (size_t) producers * perProducer && vec.reserved() == vec.size());
+	std::vector<int> seen(producers * perProducer, 0);
+	for (long val : vec)
+	{
+		seen[val]++;
+	}
+	bool once = true;
+	for (int count : seen)
+	{
+		once = once && count == 1;
+	}
+	VL_CHECK(once);
+}
+
+VL_TEST(failedSegmentClaimsNoSlot)
+{
+	ConcurrentVLVector<std::string, 2, FailingAllocator<std::string>> vec;
+	vec.push_back("a");
+	vec.push_back("b");
+	failAllocations.store(true);
+	VL_CHECK_THROWS(vec.push_back("c"), std::bad_alloc);
+	failAllocations.store(false);
+	VL_CHECK(vec.reserved() == 2 && vec.size() == 2);
+	vec.push_back("c");
+	vec.push_back("d");
+	VL_CHECK(vec.size() == 4 && vec.reserved() == 4 && vec[2] == "c" && vec[3] == "d");
+	vec.clear();
+	VL_CHECK(vec.empty());
+	vec.push_back(std::string(40, 'e'));
+	VL_CHECK(vec.size() == 1 && vec[0] == std::string(40, 'e'));
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,116 @@
+/**
+ * @file    constexpr_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Compile-time tests of VLVector, built as C++20 whatever the standard of the other tests. most
+ *          checks are static_asserts, so a regression fails the build rather than the run.
+ */
+
+#include <array>
+#include <string>
+#include "../VLVector.hpp"
+#include "VLTest.hpp"
+
+static_assert(VL_HAS_CONSTEXPR, "constexpr_test must be built as C++20");
+
+typedef VLVector<int, 4> IntVector;
+
+/**
+ * @brief the squares of 0 .. N - 1, built in a VLVector and copied out to keep them
+ */
+template<size_t N>
+constexpr std::array<int, N> squares()
+{
+	IntVector vec;
+	for (int i = 0; i < (int) N; i++)
+	{
+		vec.push_back(i * i);
+	}
+	std::array<int, N> table{};
+	for (size_t i = 0; i < N; i++)
+	{
+		table[i] = vec[i];
+	}
+	return table;
+}
+
+constexpr std::array<int, 10> table = squares<10>();
+static_assert(table[0] == 0 && table[3] == 9 && table[9] == 81);
+
+/**
+ * @brief push_back, emplace_back, insert, erase, pop_back, copy and move at compile time, past the inline
+ * capacity and back
+ * @return the elements, folded into one number
+ */
+constexpr long mixed()
+{
+	IntVector vec;
+	for (int i = 0; i < 10; i++)
+	{
+		vec.push_back(i);
+	}
+	vec.emplace_back(10);
+	vec.erase(vec.begin() + 2, vec.begin() + 8); // 0 1 8 9 10
+	int more[] = {20, 21};
+	vec.insert(vec.begin() + 1, more + 0, more + 2); // 0 20 21 1 8 9 10
+	vec.insert(vec.end(), 30);                   // 0 20 21 1 8 9 10 30
+	vec.erase(vec.begin());                      // 20 21 1 8 9 10 30
+	vec.pop_back();                              // 20 21 1 8 9 10
+	IntVector copy(vec);
+	copy[0] = -1;
+	IntVector moved(std::move(copy));
+	long folded = 0;
+	for (int x : vec)
+	{
+		folded = folded * 100 + x;
+	}
+	return folded * 10 + (long) moved.size() + (moved[0] == -1 && vec[0] == 20 ? 0 : 1000000);
+}
+
+static_assert(mixed() == 2021010809106); // 20 21 1 8 9 10, then the size of the moved copy
+
+/**
+ * @brief elements with a destructor and a heap buffer of their own
+ */
+constexpr bool strings()
+{
+	VLVector<std::string, 2> vec;
+	for (int i = 0; i < 6; i++)
+	{
+		vec.push_back(std::string(30, (char) ('a' + i)));
+	}
+	vec.erase(vec.begin() + 1, vec.begin() + 5);
+	return vec.size() == 2 && vec[0][0] == 'a' && vec[1][29] == 'f';
+}
+
+static_assert(strings());
+
+/**
+ * @brief constant-initialized, so it has no inline buffer yet - the first push_back at run time takes it
+ */
+constinit IntVector early;
+
+VL_TEST(constantInitializedVectorWorksAtRunTime)
+{
+	VL_CHECK(early.empty() && early.size() == 0);
+	for (int i = 0; i < 3; i++)
+	{
+		early.push_back(i);
+	}
+	VL_CHECK(early.size() == 3 && early.capacity() == 4 && early[2] == 2);
+	for (int i = 3; i < 10; i++)
+	{
+		early.push_back(i);
+	}
+	VL_CHECK(early.size() == 10 && early[9] == 9);
+	early.clear();
+	VL_CHECK(early.empty());
+}
+
+VL_TEST(compileTimeResultsAtRunTime)
+{
+	VL_CHECK(squares<10>() == table && mixed() % 10 == 6 && strings());
+}
+
+int main() { return vlRunTests(); }
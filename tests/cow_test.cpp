@@ -0,0 +1,101 @@
+/**
+ * @file    cow_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the copy-on-write vector.
+ */
+
+#include <string>
+#include "../CowVLVector.hpp"
+#include "VLTest.hpp"
+
+typedef CowVLVector<int, 4> IntCow;
+typedef CowVLVector<std::string, 4> StringCow;
+
+/**
+ * @brief a vector of count ints 0, 1, ... count - 1
+ */
+static IntCow counted(int count)
+{
+	IntCow vec;
+	for (int i = 0; i < count; i++)
+	{
+		vec.push_back(i);
+	}
+	return vec;
+}
+
+/**
+ * @brief a vector of count strings too long for the small string buffer
+ */
+static StringCow longStrings(int count)
+{
+	StringCow vec;
+	for (int i = 0; i < count; i++)
+	{
+		vec.push_back(std::string(40, (char) ('a' + i)));
+	}
+	return vec;
+}
+
+VL_TEST(copiesShareUntilAWrite)
+{
+	IntCow a = counted(10);
+	const IntCow b(a);
+	VL_CHECK(a.use_count() == 2 && b.cbegin() == a.cbegin());
+	a.push_back(10);
+	VL_CHECK(a.use_count() == 1 && b.use_count() == 1);
+	VL_CHECK(a.size() == 11 && b.size() == 10 && b[9] == 9);
+}
+
+VL_TEST(leakedReferenceDoesNotReachLaterCopies)
+{
+	IntCow a = counted(10);
+	int &r = a[0];
+	IntCow b(a);
+	r = 42;
+	VL_CHECK(a[0] == 42 && b[0] == 0);
+	int *p = a.data();
+	IntCow c;
+	c = a;
+	p[1] = 43;
+	VL_CHECK(a[1] == 43 && c[1] == 1);
+}
+
+VL_TEST(newBufferIsShareableAgain)
+{
+	IntCow a = counted(10);
+	a[0] = 1; // leaks the buffer
+	for (int i = 0; i < 20; i++) // moves to a bigger one
+	{
+		a.push_back(i);
+	}
+	IntCow b(a);
+	VL_CHECK(a.use_count() == 2 && b[0] == 1 && b.size() == 30);
+}
+
+VL_TEST(emptyEraseKeepsTheElements)
+{
+	for (int count : {3, 10}) // inline and on the heap
+	{
+		StringCow a = longStrings(count);
+		StringCow::iterator it = a.erase(a.cbegin() + 1, a.cbegin() + 1);
+		VL_CHECK(it == a.begin() + 1 && a.size() == (size_t) count);
+		for (int i = 0; i < count; i++)
+		{
+			VL_CHECK(a[i] == std::string(40, (char) ('a' + i)));
+		}
+	}
+}
+
+VL_TEST(eraseDetachesTheSnapshot)
+{
+	StringCow a = longStrings(10);
+	const StringCow snapshot(a);
+	a.erase(a.cbegin() + 2, a.cbegin() + 8);
+	VL_CHECK(a.size() == 4 && a[2] == std::string(40, 'i'));
+	VL_CHECK(snapshot.size() == 10 && snapshot[2] == std::string(40, 'c'));
+}
+
+int main() { return vlRunTests(); }
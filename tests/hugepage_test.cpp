@@ -0,0 +1,110 @@
+/**
+ * @file    hugepage_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the huge-page allocator tiers.
+ */
+
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+#include "../VLHugePageAllocator.hpp"
+#include "VLTest.hpp"
+
+/**
+ * @brief a threshold of one small page, so the tests cross it quickly
+ */
+#define TEST_THRESHOLD 4096
+
+typedef VLHugePageAllocator<int, TEST_THRESHOLD> IntAlloc;
+
+/**
+ * @brief checks that vec holds 0, 1, ... count - 1
+ */
+template<class Vec>
+static bool holdsCount(const Vec &vec, size_t count)
+{
+	bool ok = vec.size() == count;
+	for (size_t i = 0; i < vec.size(); i++)
+	{
+		ok = ok && vec[i] == (int) i;
+	}
+	return ok;
+}
+
+/**
+ * @brief tells if p starts a page, as a mapped buffer does
+ */
+static bool pageAligned(const void *p) { return reinterpret_cast<uintptr_t>(p) % 4096 == 0; }
+
+VL_TEST(vectorCrossesTheTiers)
+{
+	HugeVLVector<int, 4, GrowOneAndHalf, ShrinkBelowWatermark<>, TEST_THRESHOLD> vec;
+	bool mapped = false;
+	for (int i = 0; i < 100000; i++)
+	{
+		vec.push_back(i);
+		mapped = mapped || vec.capacity() * sizeof(int) >= TEST_THRESHOLD;
+	}
+	VL_CHECK(mapped && holdsCount(vec, 100000));
+#ifdef __linux__
+	VL_CHECK(pageAligned(vec.data()));
+#endif
+	vec.erase(vec.begin() + 5000, vec.end()); // a smaller mapping
+	VL_CHECK(holdsCount(vec, 5000));
+	vec.erase(vec.begin() + 100, vec.end()); // back to the small tier
+	VL_CHECK(holdsCount(vec, 100) && vec.capacity() * sizeof(int) < TEST_THRESHOLD);
+	vec.erase(vec.begin() + 3, vec.end()); // inline
+	VL_CHECK(holdsCount(vec, 3) && vec.capacity() == 4);
+}
+
+VL_TEST(mappedBuffersKeepTheirBytes)
+{
+	IntAlloc alloc;
+	size_t n = TEST_THRESHOLD / sizeof(int);
+	int *p = alloc.allocate(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		p[i] = (int) i;
+	}
+	p = alloc.reallocate(p, n, 64 * n); // mremap
+	bool kept = true;
+	for (size_t i = 0; i < n; i++)
+	{
+		kept = kept && p[i] == (int) i;
+	}
+	p[64 * n - 1] = 1;
+	p = alloc.reallocate(p, 64 * n, 10); // back to the small tier, one copy
+	for (size_t i = 0; i < 10; i++)
+	{
+		kept = kept && p[i] == (int) i;
+	}
+	VL_CHECK(kept);
+	alloc.deallocate(p, 10);
+}
+
+VL_TEST(stringsInTheMappedTier)
+{
+	HugeVLVector<std::string, 2, GrowOneAndHalf, ShrinkBelowWatermark<>, TEST_THRESHOLD> vec;
+	for (int i = 0; i < 2000; i++)
+	{
+		vec.push_back(std::string(40, (char) ('a' + i % 26)));
+	}
+	VL_CHECK(vec.size() == 2000 && vec[1999] == std::string(40, 'a' + 1999 % 26));
+	vec.erase(vec.begin() + 1, vec.end());
+	VL_CHECK(vec.size() == 1 && vec[0] == std::string(40, 'a'));
+}
+
+VL_TEST(hugeSizesDoNotWrap)
+{
+	IntAlloc alloc;
+	size_t tooMany = std::numeric_limits<size_t>::max() / sizeof(int) + 2;
+	VL_CHECK_THROWS(alloc.allocate(tooMany), std::bad_array_new_length);
+	int *p = alloc.allocate(8);
+	VL_CHECK_THROWS(alloc.reallocate(p, 8, tooMany), std::bad_array_new_length);
+	alloc.deallocate(p, 8);
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,151 @@
+/**
+ * @file    io_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the binary format - the writer, the reader and the in-place view.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../VLVectorIO.hpp"
+#include "VLTest.hpp"
+
+/**
+ * @brief trivially copyable, but with no default constructor - the raw path must never build one
+ */
+struct Point
+{
+	int x, y;
+	
+	Point(int x, int y) : x(x), y(y) {}
+	
+	bool operator==(const Point &rhs) const { return x == rhs.x && y == rhs.y; }
+};
+
+/**
+ * @brief a stream buffer over bytes that cannot seek, like a pipe - the reader cannot learn the length
+ */
+struct PipeBuf : std::streambuf
+{
+	std::string bytes;
+	
+	explicit PipeBuf(std::string b) : bytes(std::move(b)) { setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size()); }
+};
+
+/**
+ * @brief the bytes of a vector written by a VLVectorWriter
+ */
+template<class Vec>
+static std::string serialized(const Vec &vec, bool checksum)
+{
+	std::ostringstream out;
+	{
+		VLVectorWriter writer(out, checksum);
+		writer.write(vec);
+	}
+	return out.str();
+}
+
+VL_TEST(rawRoundTrip)
+{
+	for (int count : {0, 3, 100000}) // empty, inline, and more than a chunk
+	{
+		VLVector<int, 8> vec;
+		for (int i = 0; i < count; i++)
+		{
+			vec.push_back(i * 7);
+		}
+		for (bool checksum : {false, true})
+		{
+			std::istringstream in(serialized(vec, checksum));
+			VLVector<int, 8> back;
+			back.push_back(-1); // replaced
+			VLVectorReader(in).read(back);
+			VL_CHECK(back == vec);
+		}
+	}
+}
+
+VL_TEST(rawReadFromAPipe)
+{
+	VLVector<Point, 4> vec;
+	for (int i = 0; i < 50000; i++)
+	{
+		vec.push_back(Point(i, -i));
+	}
+	PipeBuf pipe(serialized(vec, true));
+	std::istream in(&pipe);
+	VLVector<Point, 4> back;
+	VLVectorReader(in).read(back);
+	VL_CHECK(back.size() == vec.size() && back == vec);
+}
+
+VL_TEST(stringsRoundTrip)
+{
+	VLVector<std::string, 2> vec;
+	vec.push_back("");
+	for (int i = 0; i < 100; i++)
+	{
+		vec.push_back(std::string(i, (char) ('a' + i % 26)));
+	}
+	std::string bytes = serialized(vec, true);
+	std::istringstream in(bytes);
+	VLVector<std::string, 2> back;
+	VLVectorReader(in).read(back);
+	VL_CHECK(back == vec);
+	PipeBuf pipe(bytes);
+	std::istream piped(&pipe);
+	VLVector<std::string, 2> fromPipe;
+	VLVectorReader(piped).read(fromPipe);
+	VL_CHECK(fromPipe == vec);
+}
+
+VL_TEST(badStreamsAreRejected)
+{
+	VLVector<int, 4> vec;
+	for (int i = 0; i < 100; i++)
+	{
+		vec.push_back(i);
+	}
+	std::string bytes = serialized(vec, true);
+	std::string flipped = bytes;
+	flipped[sizeof(VLStreamHeader) + 5] ^= 1;
+	std::istringstream corrupted(flipped);
+	VLVector<int, 4> back;
+	VL_CHECK_THROWS(VLVectorReader(corrupted).read(back), std::runtime_error);
+	std::istringstream truncated(bytes.substr(0, bytes.size() - 20));
+	VL_CHECK_THROWS(VLVectorReader(truncated).read(back), std::runtime_error);
+	std::istringstream wrongType(bytes);
+	VLVector<double, 4> doubles;
+	VL_CHECK_THROWS(VLVectorReader(wrongType).read(doubles), std::runtime_error);
+	std::string huge = bytes;
+	uint64_t count = std::numeric_limits<uint64_t>::max() / 2;
+	std::memcpy(&huge[offsetof(VLStreamHeader, count)], &count, sizeof(count));
+	PipeBuf pipe(huge);
+	std::istream piped(&pipe);
+	VL_CHECK_THROWS(VLVectorReader(piped).read(back), std::runtime_error);
+}
+
+VL_TEST(viewInPlace)
+{
+	VLVector<double, 4> vec;
+	for (int i = 0; i < 1000; i++)
+	{
+		vec.push_back(i / 2.0);
+	}
+	std::string bytes = serialized(vec, true);
+	VLVectorView<double> view(bytes.data(), bytes.size());
+	VL_CHECK(view.size() == 1000 && view[999] == 499.5 && view.data() != vec.data());
+	VL_CHECK(std::equal(view.begin(), view.end(), vec.begin()));
+	bytes[sizeof(VLStreamHeader)] ^= 1;
+	VL_CHECK_THROWS(VLVectorView<double>(bytes.data(), bytes.size()), std::runtime_error);
+	VLVectorView<double> unchecked(bytes.data(), bytes.size(), false);
+	VL_CHECK(unchecked.size() == 1000);
+	VL_CHECK_THROWS(VLVectorView<double>(bytes.data(), bytes.size() - 16), std::runtime_error);
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,171 @@
+/**
+ * @file    parallel_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the work-stealing pool and the par:: algorithms, against their serial std:: versions.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../VLParallel.hpp"
+#include "VLTest.hpp"
+
+typedef VLVector<long, 16> LongVector;
+
+/**
+ * @brief a pool of its own, so the tests do not depend on the core count of the machine
+ */
+static VLThreadPool &testPool()
+{
+	static VLThreadPool pool(4);
+	return pool;
+}
+
+/**
+ * @brief sizes that stay inline, stay serial, and are cut into many ranges of which the last is short
+ */
+static const size_t sizes[] = {0, 1, 16, 5000, 100003};
+
+VL_TEST(parallelForCoversEveryIndexOnce)
+{
+	std::vector<std::atomic<int>> hits(100003);
+	testPool().parallelFor(hits.size(), 1000, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			hits[i]++;
+		}
+	});
+	VL_CHECK(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int> &h) { return h.load() == 1; }));
+}
+
+VL_TEST(nestedLoopsFromWorkers)
+{
+	std::atomic<long> sum(0);
+	testPool().parallelFor(64, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			testPool().parallelFor(1000, 10, [&](size_t b, size_t e) { sum += (long) (e - b); });
+		}
+	});
+	VL_CHECK(sum.load() == 64 * 1000);
+}
+
+VL_TEST(exceptionsReachTheCaller)
+{
+	VL_CHECK_THROWS(testPool().parallelFor(100000, 100, [](size_t begin, size_t)
+	{
+		if (begin >= 50000)
+		{
+			throw std::runtime_error("range");
+		}
+	}), std::runtime_error);
+	std::atomic<size_t> count(0); // the pool still works
+	testPool().parallelFor(100000, 100, [&](size_t begin, size_t end) { count += end - begin; });
+	VL_CHECK(count.load() == 100000);
+}
+
+VL_TEST(elementwiseAlgorithms)
+{
+	for (size_t n : sizes)
+	{
+		LongVector vec;
+		for (size_t i = 0; i < n; i++)
+		{
+			vec.push_back((long) i);
+		}
+		par::for_each(vec, [](long &x) { x *= 3; }, testPool());
+		VLVector<double, 4> halves;
+		halves.push_back(-1); // replaced
+		par::transform(vec, halves, [](long x) { return x / 2.0; }, testPool());
+		LongVector copied;
+		par::copy(vec, copied, testPool());
+		bool ok = halves.size() == n && copied == vec;
+		for (size_t i = 0; i < n; i++)
+		{
+			ok = ok && vec[i] == 3 * (long) i && halves[i] == 1.5 * (double) i;
+		}
+		VL_CHECK(ok);
+		long sum = par::reduce(vec, 7L, [](long a, long b) { return a + b; }, testPool());
+		VL_CHECK(sum == 7 + 3 * (long) (n * (n == 0 ? 0 : n - 1) / 2));
+	}
+}
+
+/**
+ * @brief trivially copyable, but with no default constructor
+ */
+struct Point
+{
+	int x, y;
+	
+	Point(int x, int y) : x(x), y(y) {}
+};
+
+VL_TEST(copyIntoUnwrittenStorage)
+{
+	VLVector<Point, 4> src;
+	for (int i = 0; i < 20000; i++)
+	{
+		src.push_back(Point(i, -i));
+	}
+	VLVector<Point, 4> dst;
+	dst.reserve(50000);
+	const Point *buffer = dst.data();
+	par::copy(src, dst, testPool());
+	bool ok = dst.size() == src.size() && dst.capacity() == 50000 && dst.data() == buffer;
+	for (int i = 0; i < 20000; i++)
+	{
+		ok = ok && dst[i].x == i && dst[i].y == -i;
+	}
+	VL_CHECK(ok);
+	src.erase(src.begin() + 10000, src.end());
+	par::copy(src, dst, testPool()); // a longer destination is cut
+	VL_CHECK(dst.size() == 10000 && dst[9999].x == 9999);
+	
+	VLVector<std::string, 4> strings;
+	for (int i = 0; i < 5000; i++)
+	{
+		strings.push_back(std::to_string(i));
+	}
+	VLVector<std::string, 4> copied;
+	copied.push_back("replaced");
+	par::copy(strings, copied, testPool());
+	VL_CHECK(copied == strings);
+}
+
+VL_TEST(sortMatchesStdSort)
+{
+	std::mt19937 rng(3);
+	for (size_t n : sizes)
+	{
+		LongVector vec;
+		std::vector<long> expected;
+		for (size_t i = 0; i < n; i++)
+		{
+			long val = (long) (rng() % 1000) - 500; // many duplicates
+			vec.push_back(val);
+			expected.push_back(val);
+		}
+		std::sort(expected.begin(), expected.end(), std::greater<long>());
+		par::sort(vec, std::greater<long>(), testPool());
+		VL_CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+	}
+	VLVector<std::string, 4> words;
+	std::vector<std::string> expected;
+	for (int i = 0; i < 20000; i++)
+	{
+		expected.push_back(std::to_string(rng() % 100000) + std::string(20, 'x'));
+		words.push_back(expected.back());
+	}
+	std::sort(expected.begin(), expected.end());
+	par::sort(words, std::less<std::string>(), testPool());
+	VL_CHECK(std::equal(words.begin(), words.end(), expected.begin(), expected.end()));
+}
+
+int main() { return vlRunTests(); }
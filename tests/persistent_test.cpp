@@ -0,0 +1,103 @@
+/**
+ * @file    persistent_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the file-backed vector.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "../PersistentVLVector.hpp"
+#include "VLTest.hpp"
+
+typedef PersistentVLVector<int> IntFile;
+typedef PersistentVLVector<uint64_t> WordFile;
+
+/**
+ * @brief a file of its own for each test, removed when the test is done
+ */
+struct TempFile
+{
+	std::string path;
+	
+	explicit TempFile(const char *name) :
+			path("/tmp/vl_" + std::to_string(getpid()) + "_" + name) { std::remove(path.c_str()); }
+	
+	~TempFile() { std::remove(path.c_str()); }
+};
+
+/**
+ * @brief overwrite the capacity in the header of a closed file
+ */
+static void patchCapacity(const std::string &path, uint64_t capacity)
+{
+	std::FILE *f = std::fopen(path.c_str(), "r+b");
+	std::fseek(f, (long) offsetof(VLFileHeader, capacity), SEEK_SET);
+	std::fwrite(&capacity, sizeof(capacity), 1, f);
+	std::fclose(f);
+}
+
+VL_TEST(reopenAttachesToTheElements)
+{
+	TempFile file("reopen");
+	{
+		IntFile vec(file.path.c_str(), 7);
+		for (int i = 0; i < 1000; i++)
+		{
+			vec.push_back(i);
+		}
+		vec.pop_back();
+	}
+	IntFile vec(file.path.c_str(), 7);
+	bool kept = vec.size() == 999 && vec.capacity() >= 999;
+	for (size_t i = 0; i < vec.size(); i++)
+	{
+		kept = kept && vec[i] == (int) i;
+	}
+	VL_CHECK(kept);
+	vec.shrink_to_fit();
+	vec.push_back(999);
+	VL_CHECK(vec.size() == 1000 && vec[999] == 999 && vec[500] == 500);
+}
+
+VL_TEST(wrongTypeIsRejected)
+{
+	TempFile file("type");
+	{
+		IntFile vec(file.path.c_str(), 1);
+		vec.push_back(1);
+	}
+	VL_CHECK_THROWS(IntFile(file.path.c_str(), 2), std::runtime_error);
+	VL_CHECK_THROWS(PersistentVLVector<double>(file.path.c_str(), 1), std::runtime_error);
+}
+
+VL_TEST(corruptedCapacityIsRejected)
+{
+	TempFile file("capacity");
+	{
+		WordFile vec(file.path.c_str());
+		vec.reserve(16); // exactly 16 slots in the file
+		vec.resize(16, 3);
+	}
+	patchCapacity(file.path, 0x2000000000000004ull); // times sizeof(uint64_t) wraps to a size that fits the file
+	VL_CHECK_THROWS(WordFile(file.path.c_str()), std::runtime_error);
+	patchCapacity(file.path, 17); // one slot past the end of the file
+	VL_CHECK_THROWS(WordFile(file.path.c_str()), std::runtime_error);
+	patchCapacity(file.path, 16);
+	WordFile vec(file.path.c_str());
+	VL_CHECK(vec.size() == 16 && vec[15] == 3);
+}
+
+VL_TEST(reserveDoesNotWrap)
+{
+	TempFile file("reserve");
+	IntFile vec(file.path.c_str());
+	VL_CHECK_THROWS(vec.reserve(std::numeric_limits<size_t>::max() / 2), std::length_error);
+	VL_CHECK(vec.capacity() == 0);
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,136 @@
+/**
+ * @file    pool_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the thread-local buffer pool.
+ */
+
+#include <thread>
+#include "../VLPoolAllocator.hpp"
+#include "VLTest.hpp"
+
+/**
+ * @brief a pooled vector that dies after the main thread's pool, at program exit
+ */
+static PooledVLVector<int, 2> survivor;
+
+/**
+ * @brief the change of the calling thread's counters for T since before
+ */
+template<class T, size_t MaxCached = 32>
+static VLPoolStats since(const VLPoolStats &before)
+{
+	const VLPoolStats &now = VLPoolAllocator<T, MaxCached>::stats();
+	return {now.hits - before.hits, now.misses - before.misses, now.recycled - before.recycled,
+			now.released - before.released};
+}
+
+VL_TEST(freedBuffersAreReused)
+{
+	VLPoolStats before = VLPoolAllocator<int>::stats();
+	const int *buffer;
+	{
+		PooledVLVector<int, 4> vec;
+		vec.reserve(10);
+		buffer = vec.data();
+	}
+	VLPoolStats first = since<int>(before);
+	VL_CHECK(first.misses == 1 && first.hits == 0 && first.recycled == 1 && first.released == 0);
+	PooledVLVector<int, 4> vec;
+	vec.reserve(10);
+	VL_CHECK(vec.data() == buffer);
+	vec.reserve(20); // another capacity, a new buffer
+	VLPoolStats second = since<int>(before);
+	VL_CHECK(second.misses == 2 && second.hits == 1 && second.recycled == 2);
+}
+
+VL_TEST(maxCachedCapsEachCapacity)
+{
+	typedef VLPoolAllocator<long, 2> Alloc;
+	Alloc alloc;
+	VLPoolStats before = Alloc::stats();
+	long *buffers[3];
+	for (long *&buffer : buffers)
+	{
+		buffer = alloc.allocate(8);
+	}
+	for (long *buffer : buffers)
+	{
+		alloc.deallocate(buffer, 8);
+	}
+	VLPoolStats stats = since<long, 2>(before);
+	VL_CHECK(stats.misses == 3 && stats.recycled == 2 && stats.released == 1);
+	Alloc::trim();
+	stats = since<long, 2>(before);
+	VL_CHECK(stats.released == 3);
+	alloc.deallocate(alloc.allocate(8), 8);
+	stats = since<long, 2>(before);
+	VL_CHECK(stats.misses == 4 && stats.hits == 0 && stats.recycled == 3);
+}
+
+VL_TEST(buffersFreedOnAnotherThread)
+{
+	VLPoolStats before = VLPoolAllocator<short>::stats();
+	VLPoolAllocator<short> alloc;
+	short *buffer = nullptr;
+	std::thread([&] { buffer = alloc.allocate(1000); }).join();
+	alloc.deallocate(buffer, 1000); // this thread never took that capacity
+	VLPoolStats stats = since<short>(before);
+	VL_CHECK(stats.misses == 0 && stats.recycled == 0 && stats.released == 1);
+}
+
+VL_TEST(oddCapacitiesDoNotGrowThePool)
+{
+	typedef VLPoolAllocator<unsigned char> Alloc; // no other test pools this type
+	Alloc alloc;
+	VLPoolStats before = Alloc::stats();
+	for (size_t n = 1; n <= 2 * VL_POOL_MAX_CLASSES; n++)
+	{
+		alloc.deallocate(alloc.allocate(n), n);
+	}
+	VLPoolStats stats = since<unsigned char>(before);
+	VL_CHECK(stats.recycled == VL_POOL_MAX_CLASSES && stats.released == VL_POOL_MAX_CLASSES);
+	unsigned char *first = alloc.allocate(1); // the pooled capacities are still served
+	unsigned char *last = alloc.allocate(2 * VL_POOL_MAX_CLASSES);
+	stats = since<unsigned char>(before);
+	VL_CHECK(stats.hits == 1 && stats.misses == 2 * VL_POOL_MAX_CLASSES + 1);
+	alloc.deallocate(first, 1);
+	alloc.deallocate(last, 2 * VL_POOL_MAX_CLASSES);
+	Alloc::trim();
+}
+
+/**
+ * @brief reads the counters of its thread's pool when it dies, after the pool
+ */
+struct LateReader
+{
+	static VLPoolStats seen;
+	
+	~LateReader() { seen = VLPoolAllocator<int>::stats(); }
+};
+
+VLPoolStats LateReader::seen{1, 1, 1, 1};
+
+VL_TEST(vectorsThatOutliveThePool)
+{
+	for (int i = 0; i < 10; i++)
+	{
+		survivor.push_back(i);
+	}
+	std::thread([]
+	{
+		thread_local LateReader reader;
+		thread_local PooledVLVector<int, 2> late; // built before the pool, so destroyed after it
+		for (int i = 0; i < 10; i++)
+		{
+			late.push_back(i);
+		}
+		(void) reader;
+	}).join();
+	VL_CHECK(survivor.size() == 10);
+	const VLPoolStats &seen = LateReader::seen;
+	VL_CHECK(seen.hits == 0 && seen.misses == 0 && seen.recycled == 0 && seen.released == 0);
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,128 @@
+/**
+ * @file    search_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the SIMD search kernels, against the standard algorithms.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../VLVector.hpp"
+#include "VLTest.hpp"
+
+/**
+ * @brief the needle, also written into the dead capacity past size() where a kernel must not find it
+ */
+#define NEEDLE 5
+
+/**
+ * @brief builds vectors of every size up to 100 (inline, then on the heap) from values 0..3 and NEEDLE, with
+ * NEEDLE in every slot past the size, and checks find, count, contains and find_first_of against std::
+ */
+template<class T>
+static bool matchesStd()
+{
+	std::mt19937 rng(7);
+	bool ok = true;
+	for (size_t n = 0; n < 100; n++)
+	{
+		for (int round = 0; round < 20; round++)
+		{
+			VLVector<T, 16, GrowOneAndHalf, ShrinkNever> vec;
+			bool withNeedle = round % 2 == 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				vec.push_back((T) (withNeedle && rng() % 8 == 0 ? NEEDLE : rng() % 4));
+			}
+			while (vec.size() < vec.capacity())
+			{
+				vec.push_back((T) NEEDLE);
+			}
+			while (vec.size() > n)
+			{
+				vec.pop_back();
+			}
+			const T needle = NEEDLE;
+			const T needles[] = {(T) 9, (T) NEEDLE, (T) 3};
+			ok = ok && vec.find(needle) == std::find(vec.begin(), vec.end(), needle);
+			ok = ok && vec.count(needle) == (size_t) std::count(vec.begin(), vec.end(), needle);
+			ok = ok && vec.contains(needle) == (std::find(vec.begin(), vec.end(), needle) != vec.end());
+			ok = ok && vec.find_first_of(needles, needles + 3) ==
+					   std::find_first_of(vec.begin(), vec.end(), needles, needles + 3);
+			ok = ok && vec.find_first_of(needles, needles) == vec.end();
+		}
+	}
+	return ok;
+}
+
+/**
+ * @brief runs one kernel over every length of a buffer that is all NEEDLE past the length, readable up to
+ * its end, and checks it against the plain loop
+ */
+template<class T, class Kernel>
+static bool kernelMatchesScalar(Kernel kernel)
+{
+	std::mt19937 rng(11);
+	std::vector<T> buf(80, (T) NEEDLE);
+	uint64_t key = NEEDLE;
+	const unsigned char *p = reinterpret_cast<const unsigned char *>(buf.data());
+	size_t readable = buf.size() * sizeof(T);
+	bool ok = true;
+	for (size_t n = 0; n < buf.size(); n++)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			buf[i] = (T) (rng() % 16 == 0 ? NEEDLE : rng() % 4);
+		}
+		for (bool counting : {false, true})
+		{
+			ok = ok && kernel(p, n * sizeof(T), readable, &key, 1, counting) ==
+					   VLSearchKernels<sizeof(T)>::scalar(p, n * sizeof(T), &key, 1, counting);
+		}
+	}
+	return ok;
+}
+
+VL_TEST(searchBytes)
+{
+	VL_CHECK(matchesStd<unsigned char>());
+	VL_CHECK(matchesStd<signed char>());
+}
+
+VL_TEST(searchShorts) { VL_CHECK(matchesStd<uint16_t>()); }
+
+VL_TEST(searchInts) { VL_CHECK(matchesStd<int32_t>()); }
+
+VL_TEST(searchLongs) { VL_CHECK(matchesStd<int64_t>()); }
+
+VL_TEST(searchGenericPath)
+{
+	VLVector<double, 4> vec;
+	for (int i = 0; i < 20; i++)
+	{
+		vec.push_back(i % 3);
+	}
+	VL_CHECK(vec.count(2.0) == 6 && vec.find(2.0) == vec.begin() + 2 && !vec.contains(3.0));
+}
+
+#if VL_SIMD_X86
+VL_TEST(eachKernelMasksItsTail)
+{
+	VL_CHECK(kernelMatchesScalar<uint8_t>(VLSearchKernels<1>::sse2));
+	VL_CHECK(kernelMatchesScalar<uint16_t>(VLSearchKernels<2>::sse2));
+	VL_CHECK(kernelMatchesScalar<uint32_t>(VLSearchKernels<4>::sse2));
+	VL_CHECK(kernelMatchesScalar<uint64_t>(VLSearchKernels<8>::sse2));
+	if (VLSearchKernels<1>::hasAvx2())
+	{
+		VL_CHECK(kernelMatchesScalar<uint8_t>(VLSearchKernels<1>::avx2));
+		VL_CHECK(kernelMatchesScalar<uint16_t>(VLSearchKernels<2>::avx2));
+		VL_CHECK(kernelMatchesScalar<uint32_t>(VLSearchKernels<4>::avx2));
+		VL_CHECK(kernelMatchesScalar<uint64_t>(VLSearchKernels<8>::avx2));
+	}
+}
+#endif
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,85 @@
+/**
+ * @file    segmented_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the segmented vector.
+ */
+
+#include <string>
+#include "../SegmentedVLVector.hpp"
+#include "VLTest.hpp"
+
+typedef SegmentedVLVector<int, 4> IntSegments;
+
+VL_TEST(emptyVectorCarriesNoSegmentTable)
+{
+	VL_CHECK(sizeof(IntSegments) <= 3 * sizeof(size_t) + 4 * sizeof(int));
+	VL_CHECK((VLSegmentMap<4>::count(std::numeric_limits<size_t>::max() / sizeof(int)) == 61));
+}
+
+VL_TEST(elementsDoNotMove)
+{
+	IntSegments vec;
+	vec.push_back(0);
+	const int *first = &vec[0];
+	int *fifth = nullptr;
+	for (int i = 1; i < 1000; i++)
+	{
+		vec.push_back(i);
+		if (i == 4)
+		{
+			fifth = &vec[4];
+		}
+	}
+	VL_CHECK(first == &vec[0] && fifth == &vec[4] && *fifth == 4);
+	bool ok = vec.size() == 1000;
+	for (int i = 0; i < 1000; i++)
+	{
+		ok = ok && vec[i] == i;
+	}
+	VL_CHECK(ok);
+}
+
+VL_TEST(segmentsAreGivenBack)
+{
+	IntSegments vec;
+	for (int i = 0; i < 100; i++)
+	{
+		vec.push_back(i);
+	}
+	vec.clear();
+	vec.push_back(7);
+	vec.shrink_to_fit();
+	VL_CHECK(vec.capacity() == 4 && vec[0] == 7);
+	vec.reserve(20); // the table comes back with the first heap segment
+	VL_CHECK(vec.capacity() >= 20 && vec[0] == 7);
+	for (int i = 1; i < 20; i++)
+	{
+		vec.push_back(i);
+	}
+	while (vec.size() > 5)
+	{
+		vec.pop_back();
+	}
+	vec.shrink_to_fit(); // the inline segment and the first heap one hold 5
+	VL_CHECK(vec.capacity() == 8 && vec[4] == 4);
+}
+
+VL_TEST(moveStealsTheSegments)
+{
+	SegmentedVLVector<std::string, 2> a;
+	for (int i = 0; i < 50; i++)
+	{
+		a.push_back(std::string(40, (char) ('a' + i % 26)));
+	}
+	const std::string *spilled = &a[10];
+	SegmentedVLVector<std::string, 2> b(std::move(a));
+	VL_CHECK(a.empty() && a.capacity() == 2 && b.size() == 50 && &b[10] == spilled);
+	a = std::move(b);
+	VL_CHECK(b.empty() && a.size() == 50 && &a[10] == spilled && a[49] == std::string(40, 'x'));
+	SegmentedVLVector<std::string, 2> c(a);
+	VL_CHECK(c == a && &c[10] != spilled);
+}
+
+int main() { return vlRunTests(); }
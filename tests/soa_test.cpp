@@ -0,0 +1,118 @@
+/**
+ * @file    soa_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the structure-of-arrays vector and its proxy rows.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../VLSoA.hpp"
+#include "VLTest.hpp"
+
+typedef StaticVLSoA<4, int, std::string, double> Rows;
+typedef std::tuple<int, std::string, double> Row;
+
+/**
+ * @brief count random rows, in a VLSoA and in a std::vector of tuples
+ */
+static void randomRows(size_t count, Rows &soa, std::vector<Row> &expected)
+{
+	std::mt19937 rng(5);
+	for (size_t i = 0; i < count; i++)
+	{
+		Row row((int) (rng() % 50), std::string(20, (char) ('a' + rng() % 26)), (double) i);
+		soa.push_back(row);
+		expected.push_back(row);
+	}
+}
+
+/**
+ * @brief checks that the rows of soa are the tuples of expected, in order
+ */
+static bool sameRows(const Rows &soa, const std::vector<Row> &expected)
+{
+	bool ok = soa.size() == expected.size();
+	for (size_t i = 0; ok && i < soa.size(); i++)
+	{
+		ok = Row(soa[i]) == expected[i];
+	}
+	return ok;
+}
+
+VL_TEST(sortProxyRows)
+{
+	for (size_t count : {0, 3, 200}) // empty, inline, on the heap
+	{
+		Rows soa;
+		std::vector<Row> expected;
+		randomRows(count, soa, expected);
+		std::sort(soa.begin(), soa.end());
+		std::sort(expected.begin(), expected.end());
+		VL_CHECK(sameRows(soa, expected));
+	}
+}
+
+VL_TEST(sortByOneField)
+{
+	Rows soa;
+	std::vector<Row> expected;
+	randomRows(300, soa, expected);
+	auto byName = [](const auto &a, const auto &b)
+	{
+		using std::get;
+		return get<1>(a) < get<1>(b);
+	};
+	std::stable_sort(soa.begin(), soa.end(), byName);
+	std::stable_sort(expected.begin(), expected.end(), byName);
+	VL_CHECK(sameRows(soa, expected));
+	VL_CHECK(std::is_sorted(soa.field<1>().begin(), soa.field<1>().end()));
+}
+
+VL_TEST(rowAlgorithms)
+{
+	Rows soa;
+	std::vector<Row> expected;
+	randomRows(50, soa, expected);
+	std::reverse(soa.begin(), soa.end());
+	std::reverse(expected.begin(), expected.end());
+	std::rotate(soa.begin(), soa.begin() + 7, soa.end());
+	std::rotate(expected.begin(), expected.begin() + 7, expected.end());
+	VL_CHECK(sameRows(soa, expected));
+	swap(soa[0], soa[1]);
+	std::swap(expected[0], expected[1]);
+	VL_CHECK(sameRows(soa, expected));
+	auto [id, name, weight] = soa[2];
+	id = -1;
+	name = "renamed";
+	VL_CHECK(std::get<0>(Row(soa[2])) == -1 && std::get<1>(Row(soa[2])) == "renamed" &&
+			 weight == std::get<2>(expected[2]));
+}
+
+VL_TEST(fieldsStayContiguous)
+{
+	Rows soa;
+	for (int i = 0; i < 100; i++)
+	{
+		soa.emplace_back(i, std::to_string(i), i / 4.0);
+	}
+	VLSpan<int> ids = soa.field<0>();
+	VL_CHECK(ids.size() == 100 && ids.data() == soa.data<0>() && ids[99] == 99);
+	double total = 0;
+	for (double w : soa.field<2>())
+	{
+		total += w;
+	}
+	VL_CHECK(total == 99 * 100 / 8.0);
+	while (soa.size() > 2)
+	{
+		soa.pop_back();
+	}
+	VL_CHECK(soa.capacity() == 4 && std::get<1>(Row(soa[1])) == "1");
+}
+
+int main() { return vlRunTests(); }
@@ -0,0 +1,637 @@
+/**
+ * @file    vlvector_test.cpp
+ * @author  Dor Neriya
+ *
+ *
+ * @brief   Tests of the core VLVector.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../VLVector.hpp"
+#include "VLTest.hpp"
+
+typedef VLVector<std::string, 4> StringVector;
+
+/**
+ * @brief a string too long for the small string buffer, so a moved-from one is visibly empty
+ */
+static std::string longString(char c) { return std::string(40, c); }
+
+/**
+ * @brief a vector of count long strings, 'a', 'b', ...
+ */
+static StringVector strings(size_t count)
+{
+	StringVector vec;
+	for (size_t i = 0; i < count; i++)
+	{
+		vec.push_back(longString((char) ('a' + i)));
+	}
+	return vec;
+}
+
+/**
+ * @brief checks that vec holds the strings of strings(count)
+ */
+static bool holdsStrings(const StringVector &vec, size_t count)
+{
+	return vec == strings(count);
+}
+
+/**
+ * @brief an int that throws on the moveBudget-th move (copyBudget-th copy) once the budget is set, and counts its
+ * live objects
+ */
+struct Fragile
+{
+	static int moveBudget; // moves left before one throws, negative for no limit
+	static int copyBudget; // the same for copy construction
+	static int live;
+	int value;
+	
+	Fragile(int v) : value(v) { live++; }
+	
+	Fragile(const Fragile &other) : value(other.value)
+	{
+		spend(copyBudget);
+		live++;
+	}
+	
+	Fragile(Fragile &&other) : value(other.value)
+	{
+		spend(moveBudget);
+		live++;
+	}
+	
+	Fragile &operator=(const Fragile &other) = default;
+	
+	Fragile &operator=(Fragile &&other)
+	{
+		spend(moveBudget);
+		value = other.value;
+		return *this;
+	}
+	
+	~Fragile() { live--; }
+	
+	static void spend(int &budget)
+	{
+		if (budget == 0)
+		{
+			throw std::runtime_error("move");
+		}
+		budget--;
+	}
+};
+
+int Fragile::moveBudget = -1;
+int Fragile::copyBudget = -1;
+int Fragile::live = 0;
+
+/**
+ * @brief a Fragile that is moved as bytes, so only the construction of the new elements can throw
+ */
+struct RelocatableFragile : Fragile
+{
+	using Fragile::Fragile;
+};
+
+template<>
+struct IsTriviallyRelocatable<RelocatableFragile> : std::true_type
+{
+};
+
+/**
+ * @brief inserts into a vector of count elements with room to spare, with every move budget until one
+ * succeeds, and checks that a throwing insert leaves the size and the live count as they were
+ * @param emplace emplace one element instead of inserting a range of two
+ */
+template<class F>
+static void insertWithThrowingMoves(size_t count, bool emplace)
+{
+	for (int budget = 0;; budget++)
+	{
+		{
+			VLVector<F, 8> vec;
+			for (size_t i = 0; i < count; i++)
+			{
+				vec.push_back(F((int) i));
+			}
+			std::vector<F> more{F(10), F(11)};
+			Fragile::moveBudget = budget;
+			bool thrown = false;
+			try
+			{
+				if (emplace)
+				{
+					vec.emplace(vec.begin() + 1, 12);
+				}
+				else
+				{
+					vec.insert(vec.begin() + 1, more.begin(), more.end());
+				}
+			}
+			catch (const std::runtime_error &)
+			{
+				thrown = true;
+			}
+			Fragile::moveBudget = -1;
+			if (!thrown)
+			{
+				VL_CHECK(vec.size() == count + (emplace ? 1 : 2) && vec[0].value == 0 &&
+						 vec[1].value == (emplace ? 12 : 10));
+				break;
+			}
+			VL_CHECK(vec.size() == count && vec[0].value == 0);
+			VL_CHECK(Fragile::live == (int) (count + more.size()));
+			vec.push_back(F(20)); // still usable
+			VL_CHECK(vec.size() == count + 1);
+		}
+		VL_CHECK(Fragile::live == 0);
+	}
+}
+
+VL_TEST(emptyEraseKeepsElements)
+{
+	for (size_t count : {3, 8}) // inline and on the heap
+	{
+		StringVector vec = strings(count);
+		for (size_t pos = 0; pos <= count; pos++)
+		{
+			auto it = vec.erase(vec.begin() + pos, vec.begin() + pos);
+			VL_CHECK(it == vec.begin() + pos);
+			VL_CHECK(holdsStrings(vec, count));
+		}
+	}
+}
+
+VL_TEST(emptyInsertKeepsElements)
+{
+	std::vector<std::string> none;
+	for (size_t count : {3, 4, 8}) // room left, full inline buffer, on the heap
+	{
+		StringVector vec = strings(count);
+		for (size_t pos = 0; pos <= count; pos++)
+		{
+			auto it = vec.insert(vec.begin() + pos, none.begin(), none.end());
+			VL_CHECK(it == vec.begin() + pos);
+			VL_CHECK(holdsStrings(vec, count));
+		}
+	}
+}
+
+VL_TEST(insertRangeOfStrings)
+{
+	std::vector<std::string> more{longString('x'), longString('y')};
+	StringVector vec = strings(2);
+	vec.insert(vec.begin() + 1, more.begin(), more.end()); // fits inline
+	VL_CHECK(vec.size() == 4 && vec[0] == longString('a') && vec[1] == longString('x') &&
+			 vec[2] == longString('y') && vec[3] == longString('b'));
+	vec.insert(vec.begin() + 2, more.begin(), more.end()); // spills
+	VL_CHECK(vec.size() == 6 && vec[2] == longString('x') && vec[3] == longString('y') &&
+			 vec[4] == longString('y') && vec[5] == longString('b'));
+	VL_CHECK(more[0] == longString('x')); // copied, not moved from
+}
+
+VL_TEST(throwingInsertKeepsTheSize)
+{
+	for (size_t count : {1, 2, 4}) // gap at the end, gap across the old end, gap inside
+	{
+		for (bool emplace : {false, true})
+		{
+			insertWithThrowingMoves<Fragile>(count, emplace);
+			insertWithThrowingMoves<RelocatableFragile>(count, emplace);
+		}
+	}
+}
+
+VL_TEST(throwingCopyWhileSpillingKeepsElements)
+{
+	for (size_t count : {2, 4}) // a full inline buffer, a full heap buffer
+	{
+		for (size_t pos = 0; pos <= count; pos++)
+		{
+			for (int budget = 0;; budget++)
+			{
+				bool thrown = false;
+				{
+					VLVector<Fragile, 2> vec; // Fragile's move may throw, so relocation copies
+					vec.reserve(count);
+					for (size_t i = 0; i < count; i++)
+					{
+						vec.push_back(Fragile((int) i));
+					}
+					Fragile::copyBudget = budget;
+					try
+					{
+						vec.insert(vec.begin() + pos, Fragile(9));
+					}
+					catch (const std::runtime_error &)
+					{
+						thrown = true;
+					}
+					Fragile::copyBudget = -1;
+					VL_CHECK(vec.size() == count + (thrown ? 0 : 1) && Fragile::live == (int) vec.size());
+					VL_CHECK(vec[0].value == (pos == 0 && !thrown ? 9 : 0));
+					VL_CHECK(vec.capacity() >= count + (thrown ? 0 : 1));
+				}
+				VL_CHECK(Fragile::live == 0);
+				if (!thrown)
+				{
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief checks that vec holds 0, 1, ... count - 1 and nothing else is alive
+ */
+template<class Vec>
+static bool holdsCount(const Vec &vec, size_t count)
+{
+	bool ok = vec.size() == count && Fragile::live == (int) count;
+	for (size_t i = 0; i < vec.size(); i++)
+	{
+		ok = ok && vec[i].value == (int) i;
+	}
+	return ok;
+}
+
+VL_TEST(relocationKeepsElements)
+{
+	{
+		VLVector<Fragile, 4> vec;
+		for (int i = 0; i < 40; i++) // inline, to the heap, and through several bigger heap buffers
+		{
+			vec.push_back(Fragile(i));
+			VL_CHECK(holdsCount(vec, i + 1));
+		}
+		vec.reserve(100);
+		VL_CHECK(vec.capacity() >= 100 && holdsCount(vec, 40));
+		vec.erase(vec.begin() + 30, vec.end()); // a smaller heap buffer
+		VL_CHECK(holdsCount(vec, 30));
+		vec.erase(vec.begin() + 3, vec.end()); // back inline
+		VL_CHECK(vec.capacity() == 4 && holdsCount(vec, 3));
+		vec.insert(vec.begin() + 3, Fragile(3));
+		vec.insert(vec.begin() + 4, Fragile(4)); // spills around the gap
+		VL_CHECK(holdsCount(vec, 5));
+		vec.shrink_to_fit();
+		VL_CHECK(holdsCount(vec, 5));
+	}
+	VL_CHECK(Fragile::live == 0);
+}
+
+VL_TEST(shrinkOfStringsAndBools)
+{
+	StringVector vec = strings(20);
+	vec.erase(vec.begin() + 10, vec.end()); // heap to a smaller heap
+	VL_CHECK(holdsStrings(vec, 10));
+	vec.erase(vec.begin() + 2, vec.end()); // heap to inline
+	VL_CHECK(vec.capacity() == 4 && holdsStrings(vec, 2));
+	
+	VLVector<bool> flags; // bytewise, shrinks through the allocator's reallocate
+	for (int i = 0; i < 100; i++)
+	{
+		flags.push_back(i % 3 == 0);
+	}
+	flags.erase(flags.begin() + 30, flags.end());
+	flags.erase(flags.begin() + 1);
+	VL_CHECK(flags.size() == 29 && flags[0] && !flags[1] && flags[2]);
+	flags.erase(flags.begin() + 5, flags.end());
+	VL_CHECK(flags.capacity() == 16 && flags.size() == 5 && flags[2] && !flags[4]);
+}
+
+VL_TEST(shrinkHysteresis)
+{
+	VLVector<int, 4> vec;
+	for (int i = 0; i < 64; i++)
+	{
+		vec.push_back(i);
+	}
+	size_t cap = vec.capacity();
+	const int *buffer = vec.data();
+	for (int round = 0; round < 100; round++) // push/pop around the growth point keeps the buffer
+	{
+		vec.pop_back();
+		vec.push_back(round);
+	}
+	VL_CHECK(vec.capacity() == cap && vec.data() == buffer);
+	while ((vec.size() - 1) * 4 >= cap) // down to the watermark
+	{
+		vec.pop_back();
+		VL_CHECK(vec.capacity() == cap);
+	}
+	vec.pop_back(); // below it
+	VL_CHECK(vec.capacity() < cap && vec.capacity() > vec.size());
+	size_t smaller = vec.capacity();
+	vec.push_back(0);
+	vec.pop_back();
+	VL_CHECK(vec.capacity() == smaller); // no thrashing right after a shrink
+	vec.resize(2);
+	VL_CHECK(vec.capacity() == 4 && vec[1] == 1);
+}
+
+VL_TEST(shrinkPolicies)
+{
+	VLVector<int, 4, GrowOneAndHalf, ShrinkNever> never;
+	VLVector<int, 4, GrowOneAndHalf, ShrinkOnRequest> onRequest;
+	for (int i = 0; i < 64; i++)
+	{
+		never.push_back(i);
+		onRequest.push_back(i);
+	}
+	size_t cap = never.capacity();
+	never.resize(1);
+	onRequest.resize(10);
+	VL_CHECK(never.capacity() == cap && onRequest.capacity() == cap);
+	never.shrink_to_fit();
+	onRequest.shrink_to_fit();
+	VL_CHECK(never.capacity() == cap && onRequest.capacity() == 10 && onRequest[9] == 9);
+	onRequest.resize(3);
+	onRequest.shrink_to_fit();
+	VL_CHECK(onRequest.capacity() == 4 && onRequest[2] == 2);
+}
+
+VL_TEST(growthKeepsTheReservedBuffer)
+{
+	VLVector<int, 4> vec;
+	vec.reserve(1000);
+	const int *buffer = vec.data();
+	vec.resize(10);
+	VL_CHECK(vec.capacity() == 1000 && vec.data() == buffer && vec[9] == 0);
+	vec.resize(20, 7);
+	VL_CHECK(vec.capacity() == 1000 && vec.data() == buffer && vec[19] == 7);
+	vec.assign(5, 3);
+	VL_CHECK(vec.capacity() == 1000 && vec.data() == buffer && vec.size() == 5 && vec[4] == 3);
+	int some[] = {1, 2, 3};
+	vec.assign(some, some + 3);
+	VL_CHECK(vec.capacity() == 1000 && vec.data() == buffer && vec.size() == 3 && vec[2] == 3);
+	vec.resize(2); // a truncation may give the buffer back
+	VL_CHECK(vec.capacity() == 4 && vec[1] == 2);
+}
+
+VL_TEST(appendUninitialized)
+{
+	VLVector<int, 4> vec;
+	vec.push_back(1);
+	int *added = vec.append_uninitialized(2); // inline
+	VL_CHECK(added == vec.data() + 1 && vec.size() == 3 && vec.capacity() == 4);
+	added[0] = 2;
+	added[1] = 3;
+	vec.reserve(100);
+	added = vec.append_uninitialized(50);
+	VL_CHECK(vec.size() == 53 && vec.capacity() == 100 && vec[2] == 3);
+	std::fill(added, added + 50, 4);
+	added = vec.append_uninitialized(100); // past the capacity, by the growth policy
+	VL_CHECK(vec.size() == 153 && vec.capacity() >= 153 && vec[52] == 4 && added == vec.data() + 53);
+	VL_CHECK_THROWS(vec.append_uninitialized(vec.max_size()), std::length_error);
+}
+
+VL_TEST(eraseRangeOfStrings)
+{
+	StringVector vec = strings(10);
+	vec.erase(vec.begin() + 1, vec.begin() + 8); // back to the inline buffer
+	VL_CHECK(vec.size() == 3 && vec[0] == longString('a') && vec[1] == longString('i') &&
+			 vec[2] == longString('j'));
+	vec.erase(vec.begin(), vec.end());
+	VL_CHECK(vec.empty());
+}
+
+VL_TEST(moveStealsTheHeapBuffer)
+{
+	StringVector vec = strings(8);
+	const std::string *buffer = vec.data();
+	StringVector moved(std::move(vec));
+	VL_CHECK(moved.data() == buffer && holdsStrings(moved, 8));
+	VL_CHECK(vec.empty());
+	StringVector assigned = strings(2);
+	assigned = std::move(moved);
+	VL_CHECK(assigned.data() == buffer && holdsStrings(assigned, 8) && moved.empty());
+	vec.push_back(longString('z')); // a moved-from vector is usable again
+	VL_CHECK(vec.size() == 1 && vec[0] == longString('z'));
+}
+
+VL_TEST(moveOfInlineElements)
+{
+	StringVector vec = strings(3);
+	StringVector moved(std::move(vec));
+	VL_CHECK(holdsStrings(moved, 3) && vec.empty());
+	StringVector assigned = strings(8); // a heap buffer that is given back
+	assigned = std::move(moved);
+	VL_CHECK(holdsStrings(assigned, 3) && moved.empty());
+}
+
+VL_TEST(moveOnlyElements)
+{
+	VLVector<std::unique_ptr<int>, 2> vec;
+	for (int i = 0; i < 5; i++)
+	{
+		vec.push_back(std::make_unique<int>(i));
+	}
+	vec.emplace(vec.begin() + 1, new int(10));
+	std::unique_ptr<int> &last = vec.emplace_back(new int(20));
+	VL_CHECK(*last == 20 && &last == &vec[vec.size() - 1]);
+	VLVector<std::unique_ptr<int>, 2> moved(std::move(vec));
+	VL_CHECK(moved.size() == 7 && *moved[0] == 0 && *moved[1] == 10 && *moved[2] == 1 && *moved[6] == 20);
+}
+
+VL_TEST(pushBackMovesTheArgument)
+{
+	StringVector vec;
+	std::string value = longString('a');
+	vec.push_back(std::move(value));
+	VL_CHECK(value.empty() && vec[0] == longString('a'));
+	std::string kept = longString('b');
+	vec.push_back(kept);
+	VL_CHECK(kept == longString('b') && vec[1] == longString('b'));
+}
+
+VL_TEST(emplaceFromOwnElement)
+{
+	for (size_t count : {3, 4}) // with room, and with a spill that frees the argument's buffer
+	{
+		StringVector vec = strings(count);
+		vec.emplace(vec.begin(), vec[count - 1]);
+		VL_CHECK(vec.size() == count + 1 && vec[0] == vec[count]);
+		vec.push_back(vec[0]);
+		VL_CHECK(vec[count + 1] == vec[0]);
+	}
+}
+
+VL_TEST(insertRangeUsesTheVectorsResource)
+{
+	char buffer[4096];
+	std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+	pmr::VLVector<int, 2> vec(&resource);
+	int values[] = {1, 2, 3, 4, 5};
+	std::pmr::memory_resource *old = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+	vec.insert(vec.begin(), values + 0, values + 5);
+	vec.insert(vec.begin() + 2, values + 0, values + 5);
+	std::pmr::set_default_resource(old);
+	VL_CHECK(vec.size() == 10 && vec[0] == 1 && vec[2] == 1 && vec[6] == 5 && vec[9] == 5);
+}
+
+VL_TEST(sizesDoNotWrap)
+{
+	VL_CHECK_THROWS(VLAllocator<double>().allocate(VLAllocator<double>::max_size() + 1), std::bad_array_new_length);
+	VLVector<double> vec;
+	VL_CHECK(vec.max_size() == VLAllocator<double>::max_size());
+	VL_CHECK_THROWS(vec.reserve(vec.max_size() + 1), std::length_error);
+	VL_CHECK_THROWS(vec.resize(vec.max_size() + 1), std::length_error);
+	VL_CHECK(vec.empty());
+	
+	size_t max = std::numeric_limits<size_t>::max();
+	VL_CHECK(GrowOneAndHalf::grow(max - 1, 0, 1) == max);
+	VL_CHECK(GrowDouble::grow(max / 2 + 2, max / 2 + 1, 1) == max);
+	VL_CHECK(GrowPowerOfTwo::grow(max / 2 + 2, 0, 1) == max);
+	VL_CHECK(GrowPowerOfTwo::grow(max / 2 + 1, 0, 1) == max / 2 + 1);
+	VL_CHECK(GrowMallocSizeClass::grow(max / 2, 0, 8) >= max / 2);
+}
+
+/**
+ * @brief checks every comparison operator of two vectors against std::lexicographical_compare and std::equal
+ * over the same elements
+ */
+template<class T>
+static bool comparesLikeStd(const std::vector<T> &a, const std::vector<T> &b)
+{
+	VLVector<T, 8> va(a.begin(), a.end());
+	VLVector<T, 8> vb(b.begin(), b.end());
+	bool less = std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+	bool greater = std::lexicographical_compare(b.begin(), b.end(), a.begin(), a.end());
+	bool equal = a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+	return (va < vb) == less && (va > vb) == greater && (va <= vb) == !greater && (va >= vb) == !less &&
+		   (va == vb) == equal && (va != vb) == !equal;
+}
+
+/**
+ * @brief random pairs of vectors drawn from a few values, so equal lengths, shared prefixes and a vector
+ * that is a prefix of the other all come up. lengths reach past a 64-byte block of the memcmp path
+ */
+template<class T>
+static bool randomPairsCompareLikeStd(std::vector<T> values)
+{
+	std::mt19937 rng(17);
+	bool ok = true;
+	for (int round = 0; round < 2000; round++)
+	{
+		std::vector<T> a(rng() % 80);
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			a[i] = values[rng() % values.size()];
+		}
+		std::vector<T> b(a.begin(), a.begin() + rng() % (a.size() + 1)); // a prefix of a
+		size_t more = rng() % 3;
+		for (size_t i = 0; i < more; i++)
+		{
+			b.push_back(values[rng() % values.size()]);
+		}
+		if (rng() % 4 == 0 && !a.empty()) // same length, one late difference
+		{
+			b = a;
+			b.back() = values[rng() % values.size()];
+		}
+		ok = ok && comparesLikeStd(a, b) && comparesLikeStd(b, a) && comparesLikeStd(a, a);
+	}
+	return ok;
+}
+
+VL_TEST(compareNegativeInts)
+{
+	VL_CHECK(randomPairsCompareLikeStd<int>({-70000, -1, 0, 1, 256, 70000}));
+	VL_CHECK(comparesLikeStd<int>({-1}, {1})); // -1 has the larger first byte
+	VL_CHECK(comparesLikeStd<long long>({0, -1}, {0, 1}));
+}
+
+VL_TEST(compareBytes)
+{
+	VL_CHECK(randomPairsCompareLikeStd<unsigned char>({0, 1, 127, 128, 255}));
+	VL_CHECK(randomPairsCompareLikeStd<signed char>({-128, -1, 0, 1, 127}));
+	VL_CHECK(randomPairsCompareLikeStd<char>({(char) -1, 0, 'a', 127}));
+	VL_CHECK(randomPairsCompareLikeStd<bool>({false, true}));
+	VL_CHECK(comparesLikeStd<unsigned char>({}, {}) && comparesLikeStd<unsigned char>({}, {0}));
+}
+
+VL_TEST(compareStrings)
+{
+	VL_CHECK(randomPairsCompareLikeStd<std::string>({"", "a", "ab", longString('b')}));
+}
+
+VL_TEST(eraseUnorderedMovesTheLastItem)
+{
+	StringVector vec = strings(10);
+	StringVector::iterator it = vec.erase_unordered(vec.begin() + 2);
+	VL_CHECK(it == vec.begin() + 2 && vec.size() == 9 && vec[2] == longString('j') && vec[8] == longString('i'));
+	it = vec.erase_unordered(vec.end() - 1); // the last item itself
+	VL_CHECK(it == vec.end() && vec.size() == 8 && vec[7] == longString('h'));
+	while (vec.size() > 1)
+	{
+		vec.erase_unordered(vec.begin());
+	}
+	VL_CHECK(vec.size() == 1 && vec.capacity() == 4);
+	
+	VLVector<std::unique_ptr<int>, 2> owners; // moved as bytes
+	for (int i = 0; i < 6; i++)
+	{
+		owners.push_back(std::make_unique<int>(i));
+	}
+	owners.erase_unordered(owners.begin());
+	VL_CHECK(owners.size() == 5 && *owners[0] == 5 && *owners[4] == 4);
+}
+
+VL_TEST(eraseIfInOnePass)
+{
+	for (size_t count : {0, 3, 10, 26}) // empty, inline and spilled
+	{
+		StringVector vec = strings(count);
+		std::vector<std::string> expected(vec.begin(), vec.end());
+		auto odd = [](const std::string &s) { return (s[0] - 'a') % 2 == 1; };
+		expected.erase(std::remove_if(expected.begin(), expected.end(), odd), expected.end());
+		size_t removed = vec.erase_if(odd);
+		VL_CHECK(removed == count - expected.size());
+		VL_CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+	}
+	StringVector all = strings(10);
+	VL_CHECK(all.erase_if([](const std::string &) { return true; }) == 10 && all.empty() && all.capacity() == 4);
+	StringVector none = strings(10);
+	VL_CHECK(none.erase_if([](const std::string &) { return false; }) == 0 && holdsStrings(none, 10));
+}
+
+VL_TEST(throwingEraseIfKeepsTheRest)
+{
+	{
+		VLVector<RelocatableFragile, 4> vec;
+		for (int i = 0; i < 10; i++)
+		{
+			vec.push_back(RelocatableFragile(i));
+		}
+		int seen = 0;
+		VL_CHECK_THROWS(vec.erase_if([&](const RelocatableFragile &f)
+		{
+			if (++seen == 7)
+			{
+				throw std::runtime_error("pred");
+			}
+			return f.value % 2 == 0;
+		}), std::runtime_error);
+		bool ok = vec.size() == 7 && Fragile::live == 7; // 1, 3, 5 kept, 6 ... 9 not visited
+		int expected[] = {1, 3, 5, 6, 7, 8, 9};
+		for (size_t i = 0; i < vec.size() && ok; i++)
+		{
+			ok = vec[i].value == expected[i];
+		}
+		VL_CHECK(ok);
+	}
+	VL_CHECK(Fragile::live == 0);
+}
+
+int main() { return vlRunTests(); }